@@ -0,0 +1,88 @@
+#pragma once
+#include <array>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+
+// --- Alfabetos ---------------------------------------------------------------
+// Un alfabeto traduce cada byte a un índice de hijo con una tabla constexpr de
+// 256 entradas: una lectura por carácter, sin las ramas ni el locale de
+// isalpha/tolower. Todos exponen:
+//   size        -> Σ: cantidad de índices, incluido el fin de palabra
+//   end_index   -> índice del fin de palabra; es el último, así que en los
+//                  empates las palabras más largas le ganan a la que termina
+//   end_symbol  -> carácter que pide el terminal en descend ('$')
+//   index(c)    -> índice del byte c, o -1 si se descarta
+//   symbol(i)   -> byte canónico del índice i (index(symbol(i)) == i)
+// El Trie dimensiona los hijos con `size`, de modo que el tamaño del nodo
+// sale del alfabeto en tiempo de compilación.
+
+// Marca común para que el Trie reconozca la opción de alfabeto.
+struct AlphabetOption {};
+
+namespace trie_detail {
+/**
+ * @brief Alfabeto por tabla: letras ASCII (sin distinguir mayúsculas), luego
+ * los dígitos si Digits y los bytes 0x80..0xFF si HighBytes, y al final el
+ * fin de palabra. El resto de los bytes se descarta.
+ */
+template <bool Digits, bool HighBytes>
+struct TableAlphabet : AlphabetOption {
+    static constexpr int end_index = 26 + (Digits ? 10 : 0) + (HighBytes ? 128 : 0);
+    static constexpr size_t size = end_index + 1;
+    static constexpr char end_symbol = '$';
+
+    static constexpr std::array<int16_t, 256> make_table() {
+        std::array<int16_t, 256> t{};
+        for (int b = 0; b < 256; ++b) t[b] = -1;
+        for (int i = 0; i < 26; ++i) {
+            t['a' + i] = static_cast<int16_t>(i);
+            t['A' + i] = static_cast<int16_t>(i);
+        }
+        if (Digits) {
+            for (int i = 0; i < 10; ++i) t['0' + i] = static_cast<int16_t>(26 + i);
+        }
+        if (HighBytes) {
+            for (int b = 0x80; b < 0x100; ++b) t[b] = static_cast<int16_t>(end_index - 128 + (b - 0x80));
+        }
+        t[static_cast<unsigned char>(end_symbol)] = end_index;
+        return t;
+    }
+
+    static constexpr std::array<char, size> make_symbols() {
+        std::array<char, size> s{};
+        for (int b = 0; b < 256; ++b) {
+            if (table[b] >= 0) s[table[b]] = static_cast<char>(b);   // la minúscula queda al final
+        }
+        return s;
+    }
+
+    static constexpr std::array<int16_t, 256> table = make_table();
+    static constexpr std::array<char, size> symbols = make_symbols();
+
+    static constexpr int index(char c) { return table[static_cast<unsigned char>(c)]; }
+    static constexpr char symbol(int i) { return symbols[i]; }
+};
+} // namespace trie_detail
+
+// 'a'..'z' sin distinguir mayúsculas y '$' (Σ = 27, por defecto).
+struct LowercaseAlphabet : trie_detail::TableAlphabet<false, false> {};
+
+// Letras y dígitos (Σ = 37).
+struct AlphanumericAlphabet : trie_detail::TableAlphabet<true, false> {};
+
+// Letras, dígitos y cada byte >= 0x80 por separado (Σ = 165): una palabra en
+// UTF-8 se guarda byte a byte, así que los acentos y la ñ no se pierden.
+struct Utf8ByteAlphabet : trie_detail::TableAlphabet<true, true> {};
+
+// LowercaseAlphabet con isalpha/tolower, como antes de las tablas: solo sirve
+// de referencia para medir. Depende del locale (en "C" coincide con la tabla).
+struct CtypeAlphabet : LowercaseAlphabet {
+    static int index(char c) {
+        if (c == end_symbol) return end_index;
+        if (std::isalpha(static_cast<unsigned char>(c))) {
+            return std::tolower(static_cast<unsigned char>(c)) - 'a';
+        }
+        return -1;
+    }
+};
@@ -0,0 +1,246 @@
+#pragma once
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "alphabet.hpp"
+
+/**
+ * @class Dawg
+ * @brief Autómata acíclico mínimo (DAWG) con la mejor sugerencia de un Trie
+ * congelado, para servir prefijos en modo solo lectura.
+ *
+ * Cada estado corresponde a una clase de nodos del trie con el mismo conjunto
+ * de sufijos. Además de sus transiciones guarda un byte: si es final (el
+ * prefijo es una palabra) y por qué arista sigue su mejor sugerencia (una
+ * letra, '$' si la sugerencia termina ahí, o ninguna). Como la arista es
+ * relativa al estado, dos nodos con los mismos sufijos y la misma sugerencia
+ * relativa (p.ej. "c" y "b" si sugieren "cat" y "bat") se funden; dos que
+ * sugieren sufijos distintos no, así que la minimización respeta las
+ * sugerencias. Las prioridades no se guardan: con ellas casi ningún estado
+ * se podría compartir, y para sugerir basta la arista.
+ *
+ * Los estados van numerados en BFS desde la raíz (estado 0). Las transiciones
+ * del estado s ocupan trans_[first_[s] .. first_[s + 1]) en orden de letra,
+ * cada una empaquetada en 32 bits: letra en los 5 bits altos y destino en
+ * los 27 bajos.
+ */
+class Dawg {
+public:
+    using State = uint32_t;
+    static constexpr State none = UINT32_MAX;
+
+    /**
+     * @brief Construye el autómata a partir de un Trie (cualquier política y opciones).
+     * @details Recorre el trie en postorden con una pila explícita; cada nodo
+     * se identifica por su firma (final, mejor arista y transiciones a
+     * estados ya registrados), así que los nodos equivalentes comparten
+     * estado. Solo usa la API pública: descend y autocomplete.
+     * Complejidad: O(nodos del trie) esperado.
+     */
+    template <typename TrieT>
+    explicit Dawg(const TrieT& trie) {
+        using Node = typename TrieT::Node;
+        static_assert(TrieT::sigma == LowercaseAlphabet::size, "Dawg: etiquetas de 5 bits, Σ = 27");
+        struct Frame {
+            const Node* v;
+            int c;                              // próxima letra a revisar
+        };
+        std::unordered_map<std::string, State> registry;
+        std::vector<std::vector<uint32_t>> sigs;    // firma en construcción por profundidad
+        std::vector<uint32_t> first{0}, trans;      // numeración en postorden
+        std::vector<uint8_t> info;
+
+        auto open = [&](const Node* v, size_t depth) {
+            if (sigs.size() <= depth) sigs.resize(depth + 1);
+            sigs[depth].assign(1, state_info(trie, v));
+        };
+        std::vector<Frame> stack{{trie.root(), 0}};
+        open(trie.root(), 0);
+        State root = none;
+        while (!stack.empty()) {
+            Frame& f = stack.back();
+            Node* u = nullptr;
+            while (f.c < 26 && !(u = trie.descend(const_cast<Node*>(f.v), LowercaseAlphabet::symbol(f.c)))) {
+                ++f.c;
+            }
+            if (u) {
+                ++f.c;
+                open(u, stack.size());
+                stack.push_back({u, 0});
+                continue;
+            }
+
+            // Subárbol completo: se registra o se reutiliza su estado
+            const std::vector<uint32_t>& sig = sigs[stack.size() - 1];
+            std::string key(reinterpret_cast<const char*>(sig.data()), sig.size() * sizeof(uint32_t));
+            auto [it, added] = registry.emplace(std::move(key), static_cast<State>(info.size()));
+            if (added) {
+                assert(info.size() < (size_t(1) << 27) && "Dawg: demasiados estados");
+                info.push_back(static_cast<uint8_t>(sig[0]));
+                trans.insert(trans.end(), sig.begin() + 1, sig.end());
+                first.push_back(static_cast<uint32_t>(trans.size()));
+            }
+            stack.pop_back();
+            if (stack.empty()) {
+                root = it->second;
+            } else {
+                sigs[stack.size() - 1].push_back(pack(stack.back().c - 1, it->second));
+            }
+        }
+        renumber(root, first, trans, info);
+    }
+
+    State root() const { return 0; }
+
+    // Estado tras leer c desde s (none si no hay palabra con ese prefijo).
+    State descend(State s, char c) const {
+        int idx = letter_index(c);
+        if (s == none || idx < 0) return none;
+        for (uint32_t i = first_[s], end = first_[s + 1]; i < end; ++i) {
+            uint32_t label = trans_[i] >> label_shift;
+            if (label == static_cast<uint32_t>(idx)) return trans_[i] & target_mask;
+            if (label > static_cast<uint32_t>(idx)) break;
+        }
+        return none;
+    }
+
+    State descend_prefix(std::string_view pref) const {
+        State s = root();
+        for (char ch : pref) {
+            s = descend(s, ch);
+            if (s == none) return none;
+        }
+        return s;
+    }
+
+    // true si el prefijo leído hasta s es una palabra.
+    bool is_final(State s) const { return s != none && (info_[s] & final_bit); }
+
+    bool contains(std::string_view w) const { return is_final(descend_prefix(w)); }
+
+    /**
+     * @brief Letras que faltan para llegar a la mejor sugerencia desde s.
+     * @return false si s no tiene sugerencia (el trie no sugería nada ahí).
+     */
+    bool completion(State s, std::string& rest) const {
+        rest.clear();
+        if (s == none || best_edge(s) == no_edge) return false;
+        for (int e; (e = best_edge(s)) != end_edge;) {
+            rest.push_back(LowercaseAlphabet::symbol(e));
+            s = descend(s, LowercaseAlphabet::symbol(e));
+        }
+        return true;
+    }
+
+    /**
+     * @brief Mejor sugerencia para un prefijo (vacía si no hay).
+     * @details El autómata solo conoce letras en minúscula: la sugerencia es
+     * la palabra tal como la recorre el trie, sin los demás caracteres.
+     */
+    std::string autocomplete(std::string_view prefix) const {
+        std::string rest;
+        if (!completion(descend_prefix(prefix), rest)) return {};
+        std::string word;
+        for (char ch : prefix) {
+            if (letter_index(ch) >= 0) word.push_back(LowercaseAlphabet::symbol(letter_index(ch)));
+        }
+        return word + rest;
+    }
+
+    /**
+     * @brief Indica si la sugerencia desde s es exactamente s + rest, sin
+     * armarla: sigue las mejores aristas mientras coincidan con rest.
+     */
+    bool completes_to(State s, std::string_view rest) const {
+        if (s == none || best_edge(s) == no_edge) return false;
+        for (char ch : rest) {
+            int e = best_edge(s);
+            if (e != letter_index(ch)) return false;
+            s = descend(s, ch);
+        }
+        return best_edge(s) == end_edge;
+    }
+
+    size_t state_count() const { return info_.size(); }
+    size_t transition_count() const { return trans_.size(); }
+
+    // Bytes de los arreglos planos (estados y transiciones).
+    size_t bytes_used() const {
+        return first_.size() * sizeof(uint32_t) + info_.size() * sizeof(uint8_t) + trans_.size() * sizeof(uint32_t);
+    }
+
+private:
+    static constexpr unsigned label_shift = 27;
+    static constexpr uint32_t target_mask = (uint32_t(1) << label_shift) - 1;
+    static constexpr uint8_t final_bit = 0x80;
+    static constexpr int end_edge = 26;             // la sugerencia termina en este estado
+    static constexpr int no_edge = 31;              // sin sugerencia
+
+    std::vector<uint32_t> first_;                   // first_[s]: primera transición de s
+    std::vector<uint8_t> info_;                     // final_bit | mejor arista
+    std::vector<uint32_t> trans_;
+
+    static int letter_index(char c) {
+        int idx = LowercaseAlphabet::index(c);
+        return idx == LowercaseAlphabet::end_index ? -1 : idx;
+    }
+
+    static uint32_t pack(int label, State target) { return (uint32_t(label) << label_shift) | target; }
+
+    int best_edge(State s) const { return info_[s] & 0x1F; }
+
+    // Byte de estado de un nodo: si tiene '$' y qué hijo contiene su mejor terminal.
+    template <typename TrieT>
+    static uint32_t state_info(const TrieT& trie, const typename TrieT::Node* cv) {
+        auto* v = const_cast<typename TrieT::Node*>(cv);
+        auto* end = trie.descend(v, '$');
+        auto* best = trie.autocomplete(v);
+        uint32_t edge = no_edge;
+        if (best && best == end) {
+            edge = end_edge;
+        } else if (best) {
+            for (int c = 0; c < 26; ++c) {
+                auto* u = trie.descend(v, LowercaseAlphabet::symbol(c));
+                if (u && trie.autocomplete(u) == best) {
+                    edge = static_cast<uint32_t>(c);
+                    break;
+                }
+            }
+        }
+        return (end ? final_bit : 0) | edge;
+    }
+
+    // Renumera los estados en BFS desde la raíz para que los primeros niveles
+    // queden juntos, y arma los arreglos definitivos.
+    void renumber(State root, const std::vector<uint32_t>& first, const std::vector<uint32_t>& trans,
+                  const std::vector<uint8_t>& info) {
+        std::vector<State> id(info.size(), none), order{root};
+        id[root] = 0;
+        for (size_t i = 0; i < order.size(); ++i) {
+            for (uint32_t k = first[order[i]]; k < first[order[i] + 1]; ++k) {
+                State t = trans[k] & target_mask;
+                if (id[t] == none) {
+                    id[t] = static_cast<State>(order.size());
+                    order.push_back(t);
+                }
+            }
+        }
+        first_.assign(1, 0);
+        info_.clear();
+        trans_.clear();
+        first_.reserve(order.size() + 1);
+        info_.reserve(order.size());
+        trans_.reserve(trans.size());
+        for (State s : order) {
+            info_.push_back(info[s]);
+            for (uint32_t k = first[s]; k < first[s + 1]; ++k) {
+                trans_.push_back(pack(static_cast<int>(trans[k] >> label_shift), id[trans[k] & target_mask]));
+            }
+            first_.push_back(static_cast<uint32_t>(trans_.size()));
+        }
+    }
+};
@@ -0,0 +1,296 @@
+#pragma once
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "string_arena.hpp"
+#include "trie.hpp"
+
+/**
+ * @class DoubleArrayTrie
+ * @brief Trie de arreglo doble (BASE/CHECK) construido desde un Trie, con la
+ * misma API de autocompletado.
+ *
+ * El hijo por el código c del estado s está en t = base[s] + c y existe si
+ * check[t] == s. BASE y CHECK van intercalados en un solo arreglo de pares
+ * (Unit), así que descend son dos lecturas y la de check[t] trae a la caché
+ * el base[t] que usa el carácter siguiente. Los códigos son 1..26 para las
+ * letras y 27 para '$': los terminales son estados hoja, como los nodos '$'
+ * del Trie. El estado 0 es nulo y el 1 es la raíz.
+ *
+ * En arreglos paralelos, cada estado guarda el id de su mejor terminal, la
+ * prioridad de ese terminal y su padre; update_priority propaga hacia la
+ * raíz por el arreglo de padres, con las mismas reglas y desempates que Trie.
+ * Las palabras y prioridades de los terminales viven en `Terminal`. La
+ * forma del árbol queda fija: no hay insert.
+ *
+ * @tparam PriorityPolicy Igual que en Trie.
+ */
+template <typename PriorityPolicy>
+class DoubleArrayTrie {
+public:
+    using Counter = typename PriorityPolicy::Counter;
+    using policy_type = PriorityPolicy;
+
+    // Terminal: su palabra y su prioridad (lo que entrega autocomplete).
+    struct Terminal {
+        StringArena::Handle str = 0;
+        Counter priority = 0;
+        uint32_t state = 0;                 // estado '$' en el arreglo doble
+        bool is_terminal = true;
+    };
+
+    /**
+     * @struct State
+     * @brief Índice de un estado; se usa como los Node* del Trie: se evalúa
+     * como bool y `t->is_terminal` dice si es un estado '$'.
+     */
+    struct State {
+        uint32_t index = 0;
+        bool is_terminal = false;
+
+        explicit operator bool() const { return index != 0; }
+        const State* operator->() const { return this; }
+    };
+
+    /**
+     * @brief Copia la forma, las palabras y las prioridades de un Trie.
+     * @details Recorre el trie en BFS y ubica los hijos de cada nodo en el
+     * primer base libre (first-fit desde el primer casillero vacío). Luego
+     * calcula best_* de abajo hacia arriba, así que las sugerencias son las
+     * mismas que las del trie. El contador de accesos continúa el del trie.
+     */
+    template <typename TrieT>
+    explicit DoubleArrayTrie(const TrieT& trie) : global_access_counter_(trie.access_counter()) {
+        using Node = typename TrieT::Node;
+        static_assert(TrieT::sigma == LowercaseAlphabet::size, "DoubleArrayTrie: Σ = 27");
+        grow(root_index + end_code + 1);
+        std::vector<std::pair<Node*, uint32_t>> order{{trie.root(), root_index}};
+        std::vector<std::pair<int, Node*>> kids;
+        for (size_t i = 0; i < order.size(); ++i) {
+            auto [v, s] = order[i];
+            kids.clear();
+            for (int code = 1; code <= end_code; ++code) {
+                if (Node* u = trie.descend(v, LowercaseAlphabet::symbol(code - 1))) kids.push_back({code, u});
+            }
+            if (kids.empty()) continue;
+
+            uint32_t b = find_base(kids);
+            units_[s].base = b;
+            for (auto [code, u] : kids) {
+                uint32_t t = b + code;
+                units_[t].check = s;
+                parent_[t] = s;
+                if (code == end_code) {
+                    terminals_.push_back({strings_.add(trie.word(u)), u->priority, t, true});
+                    best_[t] = static_cast<uint32_t>(terminals_.size());
+                    best_priority_[t] = u->priority;
+                } else {
+                    order.push_back({u, t});
+                }
+            }
+        }
+        state_count_ = order.size() + terminals_.size();
+        for (size_t i = order.size(); i-- > 0;) recompute_best(order[i].second);
+        trim();
+    }
+
+    DoubleArrayTrie(const DoubleArrayTrie&) = delete;
+    DoubleArrayTrie& operator=(const DoubleArrayTrie&) = delete;
+
+    State root() const { return {root_index, false}; }
+
+    // Desciende por c ('$' pide el terminal); un estado vacío si no existe.
+    State descend(State s, char c) const {
+        int code = char_to_code(c);
+        if (!s || code <= 0) return {};
+        uint32_t t = units_[s.index].base + static_cast<uint32_t>(code);
+        if (units_[t].check != s.index) return {};
+        return {t, code == end_code};
+    }
+
+    State descend_prefix(const std::string& pref) const {
+        State s = root();
+        for (char ch : pref) {
+            s = descend(s, ch);
+            if (!s) return {};
+        }
+        return s;
+    }
+
+    // Mejor terminal del subárbol de s (nullptr si no hay sugerencia).
+    const Terminal* autocomplete(State s) const {
+        if (!s || !best_[s.index]) return nullptr;
+        return &terminals_[best_[s.index] - 1];
+    }
+
+    std::string_view word(const Terminal* t) const { return strings_.get(t->str); }
+
+    /**
+     * @brief Actualiza la prioridad de un terminal y propaga hacia la raíz.
+     * @param terminal Estado obtenido con descend(v, '$').
+     * @return Cantidad de estados visitados durante la propagación.
+     */
+    size_t update_priority(State terminal) {
+        assert(terminal && terminal.is_terminal);
+        const uint32_t t = terminal.index;
+        const uint32_t id = best_[t];               // un terminal es su propio mejor
+        PriorityPolicy::touch(terminals_[id - 1].priority, global_access_counter_);
+        if constexpr (trie_detail::renormalizes<PriorityPolicy>::value) {
+            if (PriorityPolicy::epoch_full(global_access_counter_)) renormalize();
+        }
+        best_priority_[t] = terminals_[id - 1].priority;
+        if constexpr (trie_detail::is_monotonic<PriorityPolicy>::value) {
+            return propagate_increase(t);
+        } else {
+            size_t visited = 1;
+            for (uint32_t v = parent_[t]; v; v = parent_[v]) {
+                recompute_best(v);
+                ++visited;
+            }
+            return visited;
+        }
+    }
+
+    // Estados con contenido (nodos del trie de origen).
+    size_t node_count() const { return state_count_; }
+
+    // Casilleros del arreglo doble, incluidos los vacíos.
+    size_t capacity() const { return units_.size(); }
+
+    // Bytes de los arreglos y de los registros de terminales (sin la arena de strings).
+    size_t bytes_used() const {
+        return units_.size() * (sizeof(Unit) + sizeof(uint32_t) + sizeof(Counter) + sizeof(uint32_t)) +
+               terminals_.size() * sizeof(Terminal);
+    }
+
+    size_t string_bytes() const { return strings_.bytes_used(); }
+
+    Counter access_counter() const { return global_access_counter_; }
+
+private:
+    struct Unit {
+        uint32_t base = 0;
+        uint32_t check = 0;                 // padre del estado; 0 = casillero libre
+    };
+
+    static constexpr uint32_t root_index = 1;
+    static constexpr int end_code = 27;
+
+    std::vector<Unit> units_;
+    std::vector<uint32_t> best_;            // id + 1 del mejor terminal (0 = ninguno)
+    std::vector<Counter> best_priority_;
+    std::vector<uint32_t> parent_;
+    std::vector<Terminal> terminals_;
+    StringArena strings_;
+    size_t state_count_ = 0;
+    uint32_t first_free_ = root_index + 1;  // ningún casillero anterior está libre
+    Counter global_access_counter_;
+
+    // Índice de LowercaseAlphabet + 1 (0 = carácter descartado).
+    static int char_to_code(char c) { return LowercaseAlphabet::index(c) + 1; }
+
+    // Asegura n casilleros más un margen para que base + código nunca se salga.
+    void grow(size_t n) {
+        n += end_code + 1;
+        if (n <= units_.size()) return;
+        size_t cap = std::max(n, 2 * units_.size());
+        units_.resize(cap);
+        best_.resize(cap);
+        best_priority_.resize(cap);
+        parent_.resize(cap);
+    }
+
+    // Descarta la holgura de grow(): deja el último casillero ocupado y el margen.
+    void trim() {
+        size_t last = units_.size();
+        while (last > root_index + 1 && units_[last - 1].check == 0) --last;
+        size_t n = last + end_code + 1;
+        for (auto* v : {&best_, &parent_}) {
+            v->resize(n);
+            v->shrink_to_fit();
+        }
+        units_.resize(n);
+        units_.shrink_to_fit();
+        best_priority_.resize(n);
+        best_priority_.shrink_to_fit();
+    }
+
+    bool is_free(uint32_t t) const { return t > root_index && units_[t].check == 0; }
+
+    // Primer base >= 1 cuyos casilleros para todos los códigos están libres.
+    template <typename Kids>
+    uint32_t find_base(const Kids& kids) {
+        while (!is_free(first_free_)) {
+            ++first_free_;
+            grow(first_free_);
+        }
+        const uint32_t first_code = static_cast<uint32_t>(kids.front().first);
+        uint32_t b = first_free_ > first_code ? first_free_ - first_code : 1;
+        for (;; ++b) {
+            grow(b + end_code);
+            bool fits = true;
+            for (const auto& k : kids) {
+                if (!is_free(b + static_cast<uint32_t>(k.first))) {
+                    fits = false;
+                    break;
+                }
+            }
+            if (fits) return b;
+        }
+    }
+
+    // Recalcula el mejor de un estado interno: hijos en orden de código y
+    // comparación estricta, como recompute_best de Trie.
+    void recompute_best(uint32_t s) {
+        uint32_t best = 0;
+        Counter bestp = 0;
+        const uint32_t b = units_[s].base;
+        if (b) {
+            for (uint32_t code = 1; code <= end_code; ++code) {
+                uint32_t t = b + code;
+                if (units_[t].check == s && best_[t] && best_priority_[t] > bestp) {
+                    best = best_[t];
+                    bestp = best_priority_[t];
+                }
+            }
+        }
+        best_[s] = best;
+        best_priority_[s] = bestp;
+    }
+
+    // Propagación incremental para políticas monótonas (ver Trie::propagate_increase).
+    size_t propagate_increase(uint32_t t) {
+        const uint32_t id = best_[t];
+        const Counter p = best_priority_[t];
+        size_t visited = 1;
+        for (uint32_t v = parent_[t]; v; v = parent_[v]) {
+            ++visited;
+            if (best_[v] == id) {
+                if (best_priority_[v] == p) break;
+                best_priority_[v] = p;
+            } else if (p > best_priority_[v]) {
+                best_[v] = id;
+                best_priority_[v] = p;
+            } else if (p == best_priority_[v]) {
+                uint32_t before = best_[v];
+                recompute_best(v);
+                if (best_[v] == before) break;
+            } else {
+                break;
+            }
+        }
+        return visited;
+    }
+
+    // Época nueva de la política: la resta es la misma para todas las claves,
+    // así que los mejores no cambian y basta recorrer los arreglos.
+    void renormalize() {
+        PriorityPolicy::advance(global_access_counter_);
+        for (auto& p : best_priority_) p = PriorityPolicy::rebase(p);
+        for (auto& t : terminals_) t.priority = PriorityPolicy::rebase(t.priority);
+    }
+};
@@ -0,0 +1,97 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/**
+ * @class LatencyHistogram
+ * @brief Histograma de latencias al estilo HDR: cubetas log-lineales con
+ * error relativo acotado.
+ *
+ * Los valores menores que 2^SubBits se cuentan exactos; los demás se agrupan
+ * por potencia de 2 y cada potencia se divide en 2^SubBits cubetas iguales,
+ * así que un percentil se reporta con error relativo menor que 2^-SubBits
+ * (0.8 % con 7 bits) a cualquier escala, con memoria fija:
+ * (65 - SubBits) * 2^SubBits contadores. record() es O(1) y no reserva
+ * memoria; los histogramas de varias repeticiones se suman con merge().
+ */
+template <unsigned SubBits = 7>
+class LatencyHistogram {
+    static_assert(SubBits >= 1 && SubBits <= 16, "SubBits fuera de rango");
+
+public:
+    LatencyHistogram() : counts_((65 - SubBits) * sub_count, 0) {}
+
+    void record(uint64_t v) {
+        ++counts_[bucket(v)];
+        ++total_;
+        sum_ += static_cast<double>(v);
+        min_ = std::min(min_, v);
+        max_ = std::max(max_, v);
+    }
+
+    void merge(const LatencyHistogram& o) {
+        for (size_t i = 0; i < counts_.size(); ++i) counts_[i] += o.counts_[i];
+        total_ += o.total_;
+        sum_ += o.sum_;
+        min_ = std::min(min_, o.min_);
+        max_ = std::max(max_, o.max_);
+    }
+
+    void clear() {
+        std::fill(counts_.begin(), counts_.end(), 0);
+        total_ = 0;
+        sum_ = 0.0;
+        min_ = std::numeric_limits<uint64_t>::max();
+        max_ = 0;
+    }
+
+    uint64_t count() const { return total_; }
+    uint64_t min() const { return total_ ? min_ : 0; }
+    uint64_t max() const { return max_; }
+    double mean() const { return total_ ? sum_ / static_cast<double>(total_) : 0.0; }
+
+    /**
+     * @brief Valor bajo el cual queda la fracción q de las muestras.
+     * @param q Entre 0 y 1 (p.ej. 0.999 para p999).
+     * @return El mayor valor de la cubeta que contiene la muestra de rango
+     * ceil(q * count()), acotado a [min(), max()]; 0 si está vacío.
+     */
+    uint64_t percentile(double q) const {
+        if (total_ == 0) return 0;
+        q = std::clamp(q, 0.0, 1.0);
+        uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * static_cast<double>(total_))));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts_.size(); ++i) {
+            seen += counts_[i];
+            if (seen >= rank) return std::clamp(highest_in(i), min_, max_);
+        }
+        return max_;
+    }
+
+private:
+    static constexpr uint64_t sub_count = uint64_t(1) << SubBits;
+
+    std::vector<uint64_t> counts_;
+    uint64_t total_ = 0;
+    double sum_ = 0.0;
+    uint64_t min_ = std::numeric_limits<uint64_t>::max();
+    uint64_t max_ = 0;
+
+    // Cubeta de v: exacta bajo sub_count; si no, potencia de 2 y subcubeta.
+    static size_t bucket(uint64_t v) {
+        if (v < sub_count) return static_cast<size_t>(v);
+        unsigned shift = static_cast<unsigned>(63 - __builtin_clzll(v)) - SubBits;
+        return static_cast<size_t>((shift + 1) * sub_count + ((v >> shift) - sub_count));
+    }
+
+    // Mayor valor que cae en la cubeta i.
+    static uint64_t highest_in(size_t i) {
+        if (i < sub_count) return i;
+        unsigned shift = static_cast<unsigned>(i / sub_count) - 1;
+        uint64_t mantissa = i % sub_count + sub_count;
+        return ((mantissa + 1) << shift) - 1;
+    }
+};
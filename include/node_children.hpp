@@ -0,0 +1,230 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+// --- Representación de los hijos de un nodo --------------------------------
+// Ambas variantes exponen la misma interfaz:
+//   get(i)       -> enlace al hijo i (o Link{} si no existe)
+//   set(i, u)    -> asigna el hijo i; retorna los bytes de heap adicionales
+//   erase(i)     -> quita el hijo i; retorna los bytes de heap liberados
+//   empty()      -> true si el nodo no tiene hijos
+//   for_each(f)  -> recorre los hijos existentes en orden creciente de índice
+//   heap_bytes() -> bytes de heap que ocupa la representación fuera del nodo
+//   scan_width() -> casilleros que lee for_each (para la instrumentación)
+//   prefetch(i)  -> pide a la caché lo que leerá get(i), sin leer el nodo
+// El orden de for_each importa: recompute_best desempata por el primer hijo.
+
+// Marca común para que el Trie reconozca la opción de hijos.
+struct ChildrenOption {};
+
+/**
+ * @class DenseChildren
+ * @brief Arreglo fijo de N enlaces (comportamiento original).
+ * @tparam Atomic Si es true, get() lee con acquire y set() publica con release,
+ * para que un lector concurrente vea el hijo ya inicializado (modo ThreadSafe).
+ */
+template <typename Link, size_t N, bool Atomic = false>
+class DenseChildren {
+public:
+    Link get(int idx) const {
+        if constexpr (Atomic) {
+            return __atomic_load_n(&slots_[idx], __ATOMIC_ACQUIRE);
+        } else {
+            return slots_[idx];
+        }
+    }
+
+    size_t set(int idx, Link child) {
+        if constexpr (Atomic) {
+            __atomic_store_n(&slots_[idx], child, __ATOMIC_RELEASE);
+        } else {
+            slots_[idx] = child;
+        }
+        return 0;
+    }
+
+    size_t erase(int idx) { return set(idx, Link{}); }
+
+    bool empty() const {
+        for (Link u : slots_) {
+            if (u) return false;
+        }
+        return true;
+    }
+
+    template <typename F>
+    void for_each(F&& f) const {
+        for (Link u : slots_) {
+            if (u) f(u);
+        }
+    }
+
+    size_t heap_bytes() const { return 0; }
+
+    size_t scan_width() const { return N; }
+
+    void prefetch(int idx) const { __builtin_prefetch(&slots_[idx]); }
+
+private:
+    std::array<Link, N> slots_{};
+};
+
+namespace trie_detail {
+/**
+ * @class ChildBitmap
+ * @brief Bitmap de ocupación de N bits: una palabra de 32 bits si alcanza
+ * (Σ = 27) y si no ceil(N / 64) palabras de 64.
+ */
+template <size_t N, bool Small = (N <= 32)>
+class ChildBitmap {
+public:
+    bool test(int i) const { return bits_ >> i & 1; }
+    void set(int i) { bits_ |= uint32_t(1) << i; }
+    void reset(int i) { bits_ &= ~(uint32_t(1) << i); }
+    bool none() const { return bits_ == 0; }
+    unsigned count() const { return __builtin_popcount(bits_); }
+    // Bits encendidos antes de i.
+    unsigned rank(int i) const { return __builtin_popcount(bits_ & ((uint32_t(1) << i) - 1)); }
+    const void* data() const { return &bits_; }
+
+private:
+    uint32_t bits_ = 0;
+};
+
+template <size_t N>
+class ChildBitmap<N, false> {
+public:
+    bool test(int i) const { return bits_[i >> 6] >> (i & 63) & 1; }
+    void set(int i) { bits_[i >> 6] |= uint64_t(1) << (i & 63); }
+    void reset(int i) { bits_[i >> 6] &= ~(uint64_t(1) << (i & 63)); }
+    bool none() const {
+        for (uint64_t w : bits_) {
+            if (w) return false;
+        }
+        return true;
+    }
+    unsigned count() const {
+        unsigned n = 0;
+        for (uint64_t w : bits_) n += __builtin_popcountll(w);
+        return n;
+    }
+    unsigned rank(int i) const {
+        unsigned n = 0;
+        for (int k = 0; k < (i >> 6); ++k) n += __builtin_popcountll(bits_[k]);
+        return n + __builtin_popcountll(bits_[i >> 6] & ((uint64_t(1) << (i & 63)) - 1));
+    }
+    const void* data() const { return bits_.data(); }
+
+private:
+    std::array<uint64_t, (N + 63) / 64> bits_{};
+};
+} // namespace trie_detail
+
+/**
+ * @class SparseChildren
+ * @brief Bitmap de ocupación más un arreglo compacto de hijos.
+ *
+ * El hijo i vive en la posición rank(i) (hijos de índice menor) del arreglo.
+ * La capacidad es la potencia de 2 mayor o igual a la cantidad de hijos, así
+ * que no hace falta guardarla: con Σ <= 32 el bitmap es de 32 bits y el nodo
+ * ocupa 16 bytes en vez de N enlaces; con alfabetos mayores crece de a 8 bytes
+ * por cada 64 símbolos.
+ */
+template <typename Link, size_t N>
+class SparseChildren {
+public:
+    SparseChildren() = default;
+    SparseChildren(const SparseChildren&) = delete;
+    SparseChildren& operator=(const SparseChildren&) = delete;
+    SparseChildren(SparseChildren&& o) noexcept
+        : slots_(std::exchange(o.slots_, nullptr)), bitmap_(std::exchange(o.bitmap_, {})) {}
+    SparseChildren& operator=(SparseChildren&& o) noexcept {
+        std::swap(slots_, o.slots_);
+        std::swap(bitmap_, o.bitmap_);
+        return *this;
+    }
+    ~SparseChildren() { delete[] slots_; }
+
+    Link get(int idx) const {
+        if (!bitmap_.test(idx)) return Link{};
+        return slots_[bitmap_.rank(idx)];
+    }
+
+    size_t set(int idx, Link child) {
+        unsigned pos = bitmap_.rank(idx);
+        if (bitmap_.test(idx)) {
+            slots_[pos] = child;
+            return 0;
+        }
+        unsigned n = size();
+        size_t extra = 0;
+        if (n == capacity(n)) {
+            unsigned cap = n ? 2 * n : 1;
+            Link* grown = new Link[cap];
+            for (unsigned i = 0; i < n; ++i) grown[i] = slots_[i];
+            delete[] slots_;
+            slots_ = grown;
+            extra = (cap - n) * sizeof(Link);
+        }
+        for (unsigned i = n; i > pos; --i) slots_[i] = slots_[i - 1];
+        slots_[pos] = child;
+        bitmap_.set(idx);
+        return extra;
+    }
+
+    // Al bajar de una potencia de 2 el arreglo se reduce a la capacidad implícita.
+    size_t erase(int idx) {
+        if (!bitmap_.test(idx)) return 0;
+        unsigned n = size();
+        for (unsigned i = bitmap_.rank(idx); i + 1 < n; ++i) slots_[i] = slots_[i + 1];
+        bitmap_.reset(idx);
+        unsigned cap = capacity(n), shrunk = capacity(n - 1);
+        if (shrunk == cap) return 0;
+        Link* kept = shrunk ? new Link[shrunk] : nullptr;
+        for (unsigned i = 0; i + 1 < n; ++i) kept[i] = slots_[i];
+        delete[] slots_;
+        slots_ = kept;
+        return (cap - shrunk) * sizeof(Link);
+    }
+
+    bool empty() const { return bitmap_.none(); }
+
+    template <typename F>
+    void for_each(F&& f) const {
+        unsigned n = size();
+        for (unsigned i = 0; i < n; ++i) f(slots_[i]);
+    }
+
+    size_t heap_bytes() const { return capacity(size()) * sizeof(Link); }
+
+    size_t scan_width() const { return size(); }
+
+    // El arreglo de hijos se conoce recién al leer el nodo: solo el bitmap.
+    void prefetch(int /*idx*/) const { __builtin_prefetch(bitmap_.data()); }
+
+private:
+    Link* slots_ = nullptr;
+    trie_detail::ChildBitmap<N> bitmap_;
+
+    unsigned size() const { return bitmap_.count(); }
+
+    // Capacidad implícita: siguiente potencia de 2 (0 si no hay hijos).
+    static unsigned capacity(unsigned n) {
+        unsigned cap = 1;
+        if (n == 0) return 0;
+        while (cap < n) cap <<= 1;
+        return cap;
+    }
+};
+
+// Arreglo fijo de Σ enlaces por nodo (por defecto).
+struct DenseLayout : ChildrenOption {
+    template <typename Link, size_t N> using type = DenseChildren<Link, N>;
+};
+
+// Bitmap + hijos compactos indexados por popcount (cualquier Σ).
+struct SparseLayout : ChildrenOption {
+    template <typename Link, size_t N> using type = SparseChildren<Link, N>;
+};
@@ -0,0 +1,310 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+// --- Almacenamiento de nodos -----------------------------------------------
+// Cada estrategia de almacenamiento define el tipo de enlace entre nodos
+// (Link) y el almacén que los crea y libera. El Trie solo manipula Links y
+// los traduce a Node* con get(), así que puede cambiar de estrategia sin
+// tocar los algoritmos. En ambos casos un Link "nulo" se evalúa como false.
+//
+// Además cada almacén ofrece un asignador por hilo (Local) para construir
+// subárboles disjuntos en paralelo: Local::create() no se sincroniza con
+// otros Local del mismo almacén. Mientras haya Locals vivos no se debe
+// llamar a create() del almacén.
+//
+// destroy(l) devuelve un nodo a la lista libre del almacén (vacío, como recién
+// creado) y create() lo reutiliza antes de pedir memoria nueva. Los Local no
+// usan la lista libre.
+//
+// release(root) libera todos los nodos (para destruir o reemplazar el
+// almacén); clear(root) además deja el almacén como recién construido.
+
+// Marca común para que el Trie reconozca la opción de almacenamiento.
+struct StorageOption {};
+
+/**
+ * @class HeapNodeStore
+ * @brief Un `new` por nodo; los enlaces son punteros (comportamiento original).
+ */
+template <typename Node>
+class HeapNodeStore {
+public:
+    using Link = Node*;
+
+    HeapNodeStore() = default;
+    HeapNodeStore(const HeapNodeStore&) = delete;
+    HeapNodeStore& operator=(const HeapNodeStore&) = delete;
+
+    Link create() {
+        if (!free_.empty()) {
+            Link l = free_.back();
+            free_.pop_back();
+            return l;
+        }
+        ++size_;
+        return new Node();
+    }
+
+    void destroy(Link l) {
+        l->~Node();
+        new (l) Node();
+        free_.push_back(l);
+    }
+
+    Node* get(Link l) const { return l; }
+
+    /**
+     * @brief Asignador de un hilo: new ya es seguro entre hilos, solo se
+     * lleva la cuenta local y se suma al almacén al destruirlo.
+     */
+    class Local {
+    public:
+        explicit Local(HeapNodeStore& store) : store_(&store) {}
+        Local(Local&& o) noexcept : store_(o.store_), created_(o.created_) { o.created_ = 0; }
+        Local& operator=(Local&&) = delete;
+        ~Local() { store_->size_ += created_; }
+
+        Link create() {
+            ++created_;
+            return new Node();
+        }
+
+    private:
+        HeapNodeStore* store_;
+        size_t created_ = 0;
+    };
+
+    Local local() { return Local(*this); }
+
+    /**
+     * @brief Libera el subárbol de `root` de forma iterativa.
+     * @details Usa una pila explícita para no desbordar la pila de llamadas
+     * en palabras muy profundas.
+     */
+    void release(Link root) {
+        std::vector<Node*> stack;
+        if (root) stack.push_back(root);
+        while (!stack.empty()) {
+            Node* v = stack.back();
+            stack.pop_back();
+            v->next.for_each([&](Node* u) { stack.push_back(u); });
+            delete v;
+        }
+        for (Node* v : free_) delete v;
+        free_.clear();
+        size_ = 0;
+    }
+
+    void clear(Link root) { release(root); }
+
+    void swap(HeapNodeStore& o) {
+        std::swap(size_, o.size_);
+        free_.swap(o.free_);
+    }
+
+    // Bytes ocupados por los nodos, incluidos los de la lista libre (sin
+    // contar la sobrecarga del allocator).
+    size_t bytes_used() const { return size_ * sizeof(Node); }
+
+    // Nodos en la lista libre.
+    size_t free_count() const { return free_.size(); }
+
+private:
+    size_t size_ = 0;
+    std::vector<Node*> free_;
+};
+
+namespace trie_detail {
+/**
+ * @class SlabDirectory
+ * @brief Lista de bloques de T que crece sin mover los bloques.
+ *
+ * El directorio (arreglo de punteros a bloque) se reemplaza por uno más
+ * grande al crecer y los anteriores se conservan, así operator[] puede
+ * ejecutarse en paralelo con add() (lo usa el modo ThreadSafe). add() debe
+ * estar serializado.
+ */
+template <typename T>
+class SlabDirectory {
+public:
+    // Agrega un bloque y retorna su posición.
+    size_t add(std::unique_ptr<T[]> slab) {
+        size_t n = slabs_.size();
+        slabs_.push_back(std::move(slab));
+        if (n == capacity_) {
+            size_t cap = capacity_ ? 2 * capacity_ : 16;
+            std::unique_ptr<T*[]> dir(new T*[cap]());
+            for (size_t i = 0; i <= n; ++i) dir[i] = slabs_[i].get();
+            dirs_.push_back(std::move(dir));
+            capacity_ = cap;
+            dir_.store(dirs_.back().get(), std::memory_order_release);
+        } else {
+            dirs_.back()[n] = slabs_[n].get();
+        }
+        return n;
+    }
+
+    T* operator[](size_t i) const { return dir_.load(std::memory_order_acquire)[i]; }
+
+    size_t size() const { return slabs_.size(); }
+
+    // No es seguro con lectores concurrentes.
+    void swap(SlabDirectory& o) {
+        slabs_.swap(o.slabs_);
+        dirs_.swap(o.dirs_);
+        std::swap(capacity_, o.capacity_);
+        T** d = dir_.load(std::memory_order_relaxed);
+        dir_.store(o.dir_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        o.dir_.store(d, std::memory_order_relaxed);
+    }
+
+    void clear() {
+        dir_.store(nullptr, std::memory_order_relaxed);
+        dirs_.clear();
+        capacity_ = 0;
+        slabs_.clear();
+    }
+
+private:
+    std::vector<std::unique_ptr<T[]>> slabs_;
+    std::vector<std::unique_ptr<T*[]>> dirs_;   // directorios; el último es el vigente
+    std::atomic<T**> dir_{nullptr};
+    size_t capacity_ = 0;
+};
+} // namespace trie_detail
+
+/**
+ * @class ArenaNodeStore
+ * @brief Nodos en bloques contiguos ("slabs") de 2^SlabBits nodos, enlazados
+ * por índices de 32 bits.
+ *
+ * El índice 0 queda reservado como enlace nulo. Los bloques nunca se mueven,
+ * de modo que los Node* entregados siguen siendo válidos mientras viva el
+ * almacén; crear y destruir el árbol son operaciones por bloque.
+ *
+ * Los bloques se guardan en un SlabDirectory, así get() puede ejecutarse en
+ * paralelo con create() (lo usa el modo ThreadSafe).
+ *
+ * Cada Local toma bloques enteros (bajo un mutex) y los llena sin
+ * sincronización; la parte sin usar de su último bloque queda como hueco.
+ */
+template <typename Node, unsigned SlabBits = 12>
+class ArenaNodeStore {
+public:
+    using Link = uint32_t;
+    static constexpr size_t slab_size = size_t(1) << SlabBits;
+
+    ArenaNodeStore() { end_ = grow() + slab_size; }
+    ArenaNodeStore(const ArenaNodeStore&) = delete;
+    ArenaNodeStore& operator=(const ArenaNodeStore&) = delete;
+
+    Link create() {
+        if (!free_.empty()) {
+            Link l = free_.back();
+            free_.pop_back();
+            return l;
+        }
+        if (next_ == end_) {
+            next_ = grow();
+            end_ = next_ + slab_size;
+            if (!next_) next_ = 1;                  // el índice 0 es el enlace nulo
+        }
+        return static_cast<Link>(next_++);
+    }
+
+    void destroy(Link l) {
+        Node* n = get(l);
+        n->~Node();
+        new (n) Node();
+        free_.push_back(l);
+    }
+
+    // Asignador de un hilo: llena bloques propios pedidos a take_slab().
+    class Local {
+    public:
+        explicit Local(ArenaNodeStore& store) : store_(&store) {}
+
+        Link create() {
+            if (next_ == end_) {
+                next_ = store_->take_slab();
+                end_ = next_ + slab_size;
+                if (!next_) next_ = 1;
+            }
+            return static_cast<Link>(next_++);
+        }
+
+    private:
+        ArenaNodeStore* store_;
+        size_t next_ = 0;
+        size_t end_ = 0;
+    };
+
+    Local local() { return Local(*this); }
+
+    Node* get(Link l) const {
+        if (!l) return nullptr;
+        return &slabs_[l >> SlabBits][l & (slab_size - 1)];
+    }
+
+    // La liberación es por bloques: no hace falta recorrer el árbol ni pedir
+    // un bloque nuevo (el primer create() lo pide).
+    void release(Link /*root*/) {
+        slabs_.clear();
+        free_.clear();
+        next_ = end_ = 0;
+    }
+
+    void clear(Link root) {
+        release(root);
+        end_ = grow() + slab_size;
+        next_ = 1;
+    }
+
+    void swap(ArenaNodeStore& o) {
+        slabs_.swap(o.slabs_);
+        std::swap(next_, o.next_);
+        std::swap(end_, o.end_);
+        free_.swap(o.free_);
+    }
+
+    // Bytes reservados en bloques (incluye los huecos aún no usados y la
+    // lista libre).
+    size_t bytes_used() const { return slabs_.size() * slab_size * sizeof(Node); }
+
+    // Nodos en la lista libre.
+    size_t free_count() const { return free_.size(); }
+
+private:
+    trie_detail::SlabDirectory<Node> slabs_;
+    size_t next_ = 1;                                // siguiente índice de create()
+    size_t end_ = 0;                                 // fin del bloque en uso
+    std::vector<Link> free_;                         // nodos devueltos por destroy()
+    std::mutex grow_mutex_;                          // serializa take_slab()
+
+    size_t take_slab() {
+        std::lock_guard<std::mutex> guard(grow_mutex_);
+        return grow();
+    }
+
+    // Agrega un bloque y retorna el índice de su primer nodo.
+    size_t grow() { return slabs_.add(std::unique_ptr<Node[]>(new Node[slab_size]())) * slab_size; }
+};
+
+// Un `new` por nodo, enlaces Node* (por defecto).
+struct HeapStorage : StorageOption {
+    template <typename Node> using link_type = Node*;
+    template <typename Node> using store_type = HeapNodeStore<Node>;
+};
+
+// Nodos en arena con enlaces de 32 bits.
+struct ArenaStorage : StorageOption {
+    template <typename Node> using link_type = uint32_t;
+    template <typename Node> using store_type = ArenaNodeStore<Node>;
+};
@@ -0,0 +1,98 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @class PerfCounters
+ * @brief Contadores de hardware de Linux (perf_event_open) alrededor de una fase.
+ *
+ * Abre un grupo con ciclos, instrucciones, fallos de caché y de predicción de
+ * saltos, solo en espacio de usuario y para el hilo actual. Si el núcleo no lo
+ * permite (perf_event_paranoid, contenedores, VMs sin PMU u otro sistema
+ * operativo) available() es false y start()/stop() no hacen nada, así que el
+ * código que mide no necesita ramas propias.
+ */
+class PerfCounters {
+public:
+    enum Event { Cycles, Instructions, CacheMisses, BranchMisses, EventCount };
+
+    static constexpr std::array<const char*, EventCount> names = {
+        "cycles", "instructions", "cache_misses", "branch_misses"};
+
+    PerfCounters() {
+#ifdef __linux__
+        static constexpr uint64_t configs[EventCount] = {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+        for (int e = 0; e < EventCount; ++e) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[e];
+            attr.disabled = e == 0;          // el líder arranca y detiene al grupo
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP;
+            int fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, e == 0 ? -1 : fds_[0], 0));
+            if (fd < 0) {
+                close_all();
+                return;
+            }
+            fds_[e] = fd;
+        }
+        available_ = true;
+#endif
+    }
+
+    ~PerfCounters() { close_all(); }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool available() const { return available_; }
+
+    void start() {
+#ifdef __linux__
+        if (!available_) return;
+        ioctl(fds_[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    // Detiene el grupo y deja las lecturas en values (en cero si no hay PMU).
+    void stop() {
+        values_.fill(0);
+#ifdef __linux__
+        if (!available_) return;
+        ioctl(fds_[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        uint64_t buf[1 + EventCount] = {};
+        if (read(fds_[0], buf, sizeof(buf)) != static_cast<ssize_t>(sizeof(buf))) return;
+        for (int e = 0; e < EventCount; ++e) values_[e] = buf[1 + e];
+#endif
+    }
+
+    const std::array<uint64_t, EventCount>& values() const { return values_; }
+
+private:
+    std::array<int, EventCount> fds_ = {-1, -1, -1, -1};
+    std::array<uint64_t, EventCount> values_ = {};
+    bool available_ = false;
+
+    void close_all() {
+#ifdef __linux__
+        for (int& fd : fds_) {
+            if (fd >= 0) close(fd);
+            fd = -1;
+        }
+#endif
+    }
+};
@@ -0,0 +1,116 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <string_view>
+#include <type_traits>
+
+// --- Tabla de prefijos cortos -------------------------------------------------
+// NoPrefixCache (por defecto) no agrega nada al Trie. PrefixCache<D> agrega
+// una tabla fija con una entrada por cada prefijo de hasta D letras
+// (1 + L + ... + L^D entradas con L letras; 18279 con L = 26 y D = 3) que
+// guarda el nodo del prefijo y su mejor terminal. Trie::lookup_prefix la usa
+// para responder los primeros caracteres con una sola lectura, sin recorrer
+// nodos. El Trie la reescribe en el camino de cada palabra que propaga (las
+// entradas que una propagación puede cambiar son las de sus ancestros) y
+// completa al construir en bloque o compactar.
+
+// Marca común para que el Trie reconozca la opción de caché de prefijos.
+struct PrefixCacheOption {};
+
+struct NoPrefixCache : PrefixCacheOption {
+    static constexpr size_t depth = 0;
+};
+
+template <size_t D>
+struct PrefixCache : PrefixCacheOption {
+    static_assert(D >= 1 && D <= 4, "PrefixCache<D>: D entre 1 y 4");
+    static constexpr size_t depth = D;
+};
+
+namespace trie_detail {
+
+/**
+ * @class PrefixTable
+ * @brief Entradas {nodo, mejor terminal} indexadas por prefijo, por niveles:
+ * la raíz, luego los prefijos de 1 letra, los de 2, etc.
+ * @details Las entradas miden dos enlaces (8 bytes con ArenaStorage, 16 con
+ * HeapStorage) y están alineadas a su tamaño sobre un bloque alineado a 64,
+ * así que ninguna cruza una línea de caché y los niveles 0-1, los más
+ * consultados, caben en pocas líneas contiguas.
+ */
+template <typename Link, typename Alphabet, size_t Depth>
+class PrefixTable {
+public:
+    struct alignas(2 * sizeof(Link)) Entry {
+        Link node{};
+        Link best{};
+    };
+
+    // Letras que pueden formar un prefijo (todas menos '$').
+    static constexpr size_t letters = Alphabet::end_index;
+
+    static constexpr size_t capacity() {
+        size_t total = 0, width = 1;
+        for (size_t d = 0; d <= Depth; ++d, width *= letters) total += width;
+        return total;
+    }
+
+    // Posición de un prefijo: desplazamiento de su nivel + su código en base L.
+    struct Key {
+        size_t offset = 0;
+        size_t width = 1;
+        size_t code = 0;
+
+        void push(int idx) {
+            offset += width;
+            width *= letters;
+            code = code * letters + static_cast<size_t>(idx);
+        }
+        size_t slot() const { return offset + code; }
+    };
+
+    PrefixTable() : entries_(static_cast<Entry*>(::operator new(bytes(), std::align_val_t{64}))) {
+        clear();
+    }
+
+    ~PrefixTable() { ::operator delete(entries_, std::align_val_t{64}); }
+
+    PrefixTable(const PrefixTable&) = delete;
+    PrefixTable& operator=(const PrefixTable&) = delete;
+
+    /**
+     * @brief Casillero de pref.
+     * @return false si pref es más largo que Depth o tiene '$' o un carácter
+     * fuera del alfabeto (esas consultas no pasan por la tabla).
+     */
+    static bool slot(std::string_view pref, size_t& out) {
+        if (pref.size() > Depth) return false;
+        Key key;
+        for (char c : pref) {
+            int idx = Alphabet::index(c);
+            if (idx < 0 || idx == Alphabet::end_index) return false;
+            key.push(idx);
+        }
+        out = key.slot();
+        return true;
+    }
+
+    Entry& operator[](size_t s) { return entries_[s]; }
+    const Entry& operator[](size_t s) const { return entries_[s]; }
+
+    void clear() { std::fill(entries_, entries_ + capacity(), Entry{}); }
+
+    static constexpr size_t bytes() { return capacity() * sizeof(Entry); }
+
+private:
+    Entry* entries_;
+};
+
+// Lo que guarda el Trie: la tabla o nada.
+struct NoPrefixTable {};
+
+template <typename Link, typename Alphabet, size_t Depth>
+using prefix_table_t = std::conditional_t<Depth == 0, NoPrefixTable, PrefixTable<Link, Alphabet, Depth>>;
+
+} // namespace trie_detail
@@ -0,0 +1,531 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "trie.hpp"
+
+// --- Log de prioridades -----------------------------------------------------
+// Un directorio con dos archivos (versión 2, enteros en el orden de bytes de
+// la máquina):
+//   checkpoint.bin  LogFileHeader + PriorityRecord[count]: toda prioridad > 0
+//   updates.log     LogFileHeader + PriorityRecord...: usos posteriores, en orden
+// Un registro identifica al terminal por la huella de su palabra
+// (word_fingerprint), que no cambia al reconstruir el árbol desde words.txt.
+// Un registro con id = ~0 es una marca de época (la política renormalizó):
+// las prioridades anteriores pasan por Policy::rebase y el reloj toma el
+// valor del registro.
+// El log vale solo si su generación es la del checkpoint: si el proceso cae
+// entre escribir un checkpoint y empezar el log nuevo, el viejo se descarta
+// (sus registros ya están en el checkpoint).
+
+constexpr uint32_t priority_log_version = 2;
+
+struct LogFileHeader {
+    char magic[8];              // "TRIECKPT" o "TRIEWLOG"
+    uint32_t version;
+    uint32_t record_size;       // sizeof(PriorityRecord), para detectar otro formato
+    uint64_t generation;        // checkpoint al que pertenece el archivo
+    uint64_t access_counter;    // contador global al escribir el checkpoint
+    uint64_t count;             // registros del checkpoint (el log se lee hasta el final)
+    char policy[16];            // PriorityPolicy::name()
+};
+
+struct PriorityRecord {
+    uint64_t id;                // word_fingerprint de la palabra
+    uint64_t priority;          // prioridad del terminal tras el uso
+};
+
+static_assert(sizeof(LogFileHeader) == 56 && sizeof(PriorityRecord) == 16,
+              "El formato del log no debe depender del compilador");
+
+struct PriorityLogOptions {
+    size_t group_records = 4096;                    // registros por escritura (group commit)
+    std::chrono::milliseconds group_interval{5};    // espera máxima de un registro en memoria
+    size_t checkpoint_every = size_t(1) << 20;      // registros entre checkpoints (0 = solo a mano)
+    bool sync = true;                               // fdatasync tras cada grupo
+};
+
+// Lo que hizo la recuperación al abrir el log.
+struct RecoveryInfo {
+    size_t checkpoint_records = 0;
+    size_t log_records = 0;
+    size_t unknown = 0;         // palabras registradas que ya no están en el trie
+    bool stale_log = false;     // log de una generación anterior (descartado)
+    bool torn_tail = false;     // el log terminaba en un registro incompleto (se recorta)
+    size_t recomputed = 0;      // nodos recalculados por restore_priorities
+    double ms = 0.0;
+};
+
+// Contadores de escritura desde que se abrió el log.
+struct PriorityLogStats {
+    uint64_t records = 0;
+    uint64_t groups = 0;        // escrituras (y fdatasync) del hilo de fondo
+    uint64_t bytes = 0;
+    uint64_t checkpoints = 0;
+};
+
+// FNV-1a de 64 bits: identificador estable de una palabra.
+inline uint64_t word_fingerprint(std::string_view w) {
+    uint64_t h = 1469598103934665603ull;
+    for (unsigned char c : w) {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+namespace trie_detail {
+constexpr char checkpoint_magic[8] = {'T', 'R', 'I', 'E', 'C', 'K', 'P', 'T'};
+constexpr char update_log_magic[8] = {'T', 'R', 'I', 'E', 'W', 'L', 'O', 'G'};
+
+inline void write_all(int fd, const void* data, size_t bytes, const std::string& path) {
+    const char* p = static_cast<const char*>(data);
+    while (bytes > 0) {
+        ssize_t n = ::write(fd, p, bytes);
+        if (n < 0) throw std::runtime_error("PriorityLog: no se pudo escribir " + path);
+        p += n;
+        bytes -= static_cast<size_t>(n);
+    }
+}
+
+// Escribe un archivo completo al lado, lo baja a disco y lo renombra sobre
+// `path`, así que un lector ve el archivo viejo o el nuevo entero.
+inline void replace_file(const std::string& path, const LogFileHeader& h, const std::vector<PriorityRecord>& recs) {
+    std::string tmp = path + ".tmp";
+    int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) throw std::runtime_error("PriorityLog: no se pudo crear " + tmp);
+    try {
+        write_all(fd, &h, sizeof(h), tmp);
+        write_all(fd, recs.data(), recs.size() * sizeof(PriorityRecord), tmp);
+        if (::fsync(fd) != 0) throw std::runtime_error("PriorityLog: fsync falló en " + tmp);
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    ::close(fd);
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("PriorityLog: no se pudo renombrar " + tmp);
+    }
+    std::string dir = std::filesystem::path(path).parent_path().string();
+    int dfd = ::open(dir.empty() ? "." : dir.c_str(), O_RDONLY);
+    if (dfd >= 0) {
+        ::fsync(dfd);
+        ::close(dfd);
+    }
+}
+} // namespace trie_detail
+
+/**
+ * @class PriorityLog
+ * @brief Hace durables las prioridades de un Trie: log de usos con group
+ * commit, checkpoints periódicos y recuperación al abrir.
+ *
+ * update_priority actualiza el trie y deja {handle de la palabra, prioridad}
+ * en un anillo de un productor y un consumidor, sin candados ni hashing: el
+ * único costo agregado es copiar 16 bytes y publicar un índice. Un hilo de
+ * fondo vacía el anillo (cada group_records registros o cada
+ * group_interval), calcula las huellas, escribe el grupo con una sola write
+ * y un fdatasync, y lleva las últimas prioridades de cada palabra en memoria.
+ * sync() espera a que lo agregado esté en disco; lo que no alcanzó a
+ * escribirse se pierde si el proceso cae (a lo sumo group_interval de usos).
+ *
+ * Cada checkpoint_every registros (o con checkpoint()) el mismo hilo de fondo
+ * escribe esas prioridades como checkpoint y empieza un log vacío, sin tocar
+ * el trie. Cuando la política renormaliza (FrecencyPolicy) se registra una
+ * marca de época, y quien la lee (el hilo de fondo o la recuperación)
+ * reexpresa con Policy::rebase las prioridades anteriores, como hizo el trie.
+ *
+ * Al abrir, el trie debe estar recién construido con el diccionario: se
+ * aplica el último checkpoint y luego el log, todo junto con
+ * Trie::restore_priorities (un recálculo por nodo, no una propagación por
+ * registro). Lanza std::runtime_error si los archivos son de otro formato o
+ * de otra política, o si no puede escribir.
+ *
+ * Como el Trie sin ThreadSafe, admite un solo hilo escritor. Mientras el log
+ * esté abierto no se debe llamar a compact(), que cambia los handles que el
+ * hilo de fondo todavía puede leer.
+ */
+template <typename TrieT>
+class PriorityLog {
+public:
+    using Node = typename TrieT::Node;
+    using Counter = typename TrieT::Counter;
+    using Policy = typename TrieT::policy_type;
+
+    PriorityLog(TrieT& trie, const std::string& dir, PriorityLogOptions options = {})
+        : trie_(trie), options_(options),
+          checkpoint_path_((std::filesystem::path(dir) / "checkpoint.bin").string()),
+          log_path_((std::filesystem::path(dir) / "updates.log").string()) {
+        std::filesystem::create_directories(dir);
+        bool log_usable = recover();
+        if (log_usable) {
+            since_checkpoint_ = recovery_.log_records;
+        } else {
+            start_log();
+        }
+        fd_ = ::open(log_path_.c_str(), O_WRONLY | O_APPEND);
+        if (fd_ < 0) throw std::runtime_error("PriorityLog: no se pudo abrir " + log_path_);
+        renormalizations_ = trie_.renormalizations();
+        options_.group_records = std::max<size_t>(options_.group_records, 1);
+        until_wake_ = options_.group_records;
+        size_t capacity = 1;
+        while (capacity < 4 * options_.group_records) capacity *= 2;
+        ring_.resize(capacity);
+        writing_.reserve(capacity);
+        flusher_ = std::thread([this] { flush_loop(); });
+    }
+
+    PriorityLog(const PriorityLog&) = delete;
+    PriorityLog& operator=(const PriorityLog&) = delete;
+
+    // Escribe lo pendiente y cierra el log.
+    ~PriorityLog() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_one();
+        flusher_.join();
+        ::close(fd_);
+    }
+
+    /**
+     * @brief Trie::update_priority más un registro en el anillo.
+     * @return Lo que retorna Trie::update_priority.
+     */
+    size_t update_priority(Node* terminal) {
+        size_t visited = trie_.update_priority(terminal);
+        if (trie_.renormalizations() != renormalizations_) {
+            // Marca con el reloj previo a este uso: el registro que sigue lo avanza
+            renormalizations_ = trie_.renormalizations();
+            push({0, static_cast<uint64_t>(trie_.access_counter()) - 1});
+        }
+        push({terminal->str, static_cast<uint64_t>(terminal->priority)});
+        return visited;
+    }
+
+    // Espera a que todos los registros agregados estén escritos (y en disco si options.sync).
+    void sync() {
+        uint64_t target = head_.load(std::memory_order_relaxed);
+        std::unique_lock<std::mutex> lock(mutex_);
+        sync_target_ = std::max(sync_target_, target);
+        wake_.notify_one();
+        written_cv_.wait(lock, [&] { return durable_ >= target || failed_; });
+        if (failed_) throw std::runtime_error("PriorityLog: falló la escritura de " + log_path_);
+    }
+
+    /**
+     * @brief Escribe lo pendiente, guarda todas las prioridades y empieza un
+     * log vacío; espera a que termine.
+     * @details Lo hace el hilo de fondo desde las prioridades que ya lleva en
+     * memoria, sin recorrer el trie. El checkpoint se escribe al lado y se
+     * renombra, de modo que una caída deja el anterior o el nuevo completo.
+     */
+    void checkpoint() {
+        uint64_t target = head_.load(std::memory_order_relaxed);
+        std::unique_lock<std::mutex> lock(mutex_);
+        uint64_t done = stats_.checkpoints;
+        sync_target_ = std::max(sync_target_, target);
+        checkpoint_requested_ = true;
+        wake_.notify_one();
+        written_cv_.wait(lock, [&] { return stats_.checkpoints > done || failed_; });
+        if (failed_) throw std::runtime_error("PriorityLog: falló la escritura del checkpoint " + checkpoint_path_);
+    }
+
+    const RecoveryInfo& recovery() const { return recovery_; }
+
+    PriorityLogStats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+private:
+    // Registro en el anillo: handle de la palabra (0 = marca de época, con el
+    // reloj en `priority`) y prioridad tras el uso.
+    struct Pending {
+        StringArena::Handle word;
+        uint64_t priority;
+    };
+
+    // Huella reservada para las marcas de época en el archivo.
+    static constexpr uint64_t epoch_mark = ~uint64_t(0);
+
+    TrieT& trie_;
+    PriorityLogOptions options_;
+    std::string checkpoint_path_;
+    std::string log_path_;
+    int fd_ = -1;
+    size_t renormalizations_ = 0;
+    RecoveryInfo recovery_;
+
+    // Anillo: el escritor avanza head_, el hilo de fondo avanza tail_ (en
+    // líneas de caché distintas)
+    std::vector<Pending> ring_;
+    alignas(64) std::atomic<uint64_t> head_{0};
+    uint64_t seen_tail_ = 0;                // último tail_ leído por el escritor
+    size_t until_wake_ = 0;                 // registros hasta despertar al hilo de fondo
+    alignas(64) std::atomic<uint64_t> tail_{0};
+
+    // Solo del hilo de fondo (y de la recuperación, antes de lanzarlo)
+    std::vector<PriorityRecord> writing_;
+    std::unordered_map<uint64_t, uint64_t> latest_;     // huella -> última prioridad
+    uint64_t clock_ = 0;                                // reloj tras el último registro
+    uint64_t generation_ = 0;
+    size_t since_checkpoint_ = 0;
+
+    // Compartido, bajo mutex_
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;          // despierta al hilo de fondo
+    std::condition_variable written_cv_;    // avisa a sync() y checkpoint()
+    uint64_t durable_ = 0;
+    uint64_t sync_target_ = 0;
+    bool checkpoint_requested_ = false;
+    bool stop_ = false;
+    bool failed_ = false;
+    PriorityLogStats stats_;
+    std::thread flusher_;
+
+    static LogFileHeader header(const char (&magic)[8], uint64_t generation) {
+        LogFileHeader h{};
+        std::memcpy(h.magic, magic, sizeof(h.magic));
+        h.version = priority_log_version;
+        h.record_size = sizeof(PriorityRecord);
+        h.generation = generation;
+        std::strncpy(h.policy, Policy::name(), sizeof(h.policy) - 1);
+        return h;
+    }
+
+    // true si el encabezado es de este formato y esta política.
+    static bool valid(const LogFileHeader& h, const char (&magic)[8]) {
+        return std::memcmp(h.magic, magic, sizeof(h.magic)) == 0 && h.version == priority_log_version &&
+               h.record_size == sizeof(PriorityRecord) &&
+               std::strncmp(h.policy, Policy::name(), sizeof(h.policy)) == 0;
+    }
+
+    // Log vacío de la generación actual.
+    void start_log() { trie_detail::replace_file(log_path_, header(trie_detail::update_log_magic, generation_), {}); }
+
+    // Agrega un registro; si el anillo está lleno espera a que el hilo de fondo lo vacíe.
+    void push(const Pending& r) {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        while (head - seen_tail_ == ring_.size()) {
+            seen_tail_ = tail_.load(std::memory_order_acquire);
+            if (head - seen_tail_ < ring_.size()) break;
+            wake_.notify_one();
+            std::this_thread::yield();
+        }
+        ring_[head & (ring_.size() - 1)] = r;
+        head_.store(head + 1, std::memory_order_release);
+        if (--until_wake_ == 0) {
+            until_wake_ = options_.group_records;
+            wake_.notify_one();
+        }
+    }
+
+    // Lleva un registro del archivo a las últimas prioridades y al reloj.
+    void apply(const PriorityRecord& r) {
+        if (r.id == epoch_mark) {
+            if constexpr (trie_detail::renormalizes<Policy>::value) {
+                for (auto& entry : latest_) entry.second = Policy::rebase(static_cast<Counter>(entry.second));
+            }
+            clock_ = r.priority;
+            return;
+        }
+        latest_[r.id] = r.priority;
+        // Cada registro fue un uso: el reloj avanzó uno por registro
+        if constexpr (trie_detail::uses_access_counter<Policy>::value) ++clock_;
+    }
+
+    // Hilo de fondo: vacía el anillo por grupos y escribe los checkpoints.
+    void flush_loop() {
+        uint64_t tail = 0;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            wake_.wait_for(lock, options_.group_interval, [&] {
+                return stop_ || checkpoint_requested_ || sync_target_ > durable_ ||
+                       head_.load(std::memory_order_acquire) - tail >= options_.group_records;
+            });
+            uint64_t head = head_.load(std::memory_order_acquire);
+            bool requested = checkpoint_requested_;
+            if (head == tail && !requested) {
+                if (stop_) return;
+                continue;
+            }
+            lock.unlock();
+
+            // Un grupo no cruza un checkpoint automático: así el log queda
+            // con exactamente los registros posteriores
+            uint64_t upto = head;
+            if (options_.checkpoint_every) {
+                size_t room = options_.checkpoint_every - std::min(since_checkpoint_, options_.checkpoint_every);
+                upto = std::min<uint64_t>(upto, tail + room);
+            }
+            bool ok = true, checkpointed = false;
+            size_t records = static_cast<size_t>(upto - tail);
+            try {
+                writing_.clear();
+                for (uint64_t i = tail; i < upto; ++i) {
+                    const Pending& p = ring_[i & (ring_.size() - 1)];
+                    uint64_t id = p.word ? word_fingerprint(trie_.word_at(p.word)) : epoch_mark;
+                    writing_.push_back({id, p.priority});
+                    apply(writing_.back());
+                }
+                tail = upto;
+                tail_.store(tail, std::memory_order_release);
+                if (records) {
+                    trie_detail::write_all(fd_, writing_.data(), records * sizeof(PriorityRecord), log_path_);
+                    if (options_.sync) ok = ::fdatasync(fd_) == 0;
+                }
+                since_checkpoint_ += records;
+                bool due = options_.checkpoint_every && since_checkpoint_ >= options_.checkpoint_every;
+                if (ok && (due || (requested && tail == head))) {
+                    write_checkpoint();
+                    checkpointed = true;
+                }
+            } catch (const std::runtime_error&) {
+                ok = false;
+            }
+
+            lock.lock();
+            failed_ = failed_ || !ok;
+            durable_ = tail;
+            if (records) {
+                stats_.records += records;
+                stats_.bytes += records * sizeof(PriorityRecord);
+                ++stats_.groups;
+            }
+            if (checkpointed) {
+                ++stats_.checkpoints;
+                if (requested && tail == head) checkpoint_requested_ = false;
+            }
+            if (!ok) checkpoint_requested_ = false;
+            written_cv_.notify_all();
+        }
+    }
+
+    // Guarda latest_ como checkpoint de la generación siguiente y empieza su log.
+    void write_checkpoint() {
+        std::vector<PriorityRecord> recs;
+        recs.reserve(latest_.size());
+        for (const auto& [id, priority] : latest_) {
+            if (priority) recs.push_back({id, priority});
+        }
+        LogFileHeader h = header(trie_detail::checkpoint_magic, generation_ + 1);
+        h.access_counter = clock_;
+        h.count = recs.size();
+        trie_detail::replace_file(checkpoint_path_, h, recs);
+        ++generation_;
+        start_log();
+        ::close(fd_);
+        fd_ = ::open(log_path_.c_str(), O_WRONLY | O_APPEND);
+        if (fd_ < 0) throw std::runtime_error("PriorityLog: no se pudo abrir " + log_path_);
+        since_checkpoint_ = 0;
+    }
+
+    // Lee un archivo del log; false si no existe o no tiene encabezado completo.
+    static bool read_file(const std::string& path, LogFileHeader& h, std::vector<PriorityRecord>& recs,
+                          size_t& tail) {
+        FILE* f = std::fopen(path.c_str(), "rb");
+        if (!f) return false;
+        bool ok = std::fread(&h, sizeof(h), 1, f) == 1;
+        if (ok) {
+            PriorityRecord buf[4096];
+            size_t n;
+            while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0) {
+                recs.insert(recs.end(), buf, buf + n / sizeof(PriorityRecord));
+                tail = n % sizeof(PriorityRecord);
+            }
+        }
+        std::fclose(f);
+        return ok;
+    }
+
+    /**
+     * @brief Aplica el checkpoint y el log al trie; deja en latest_ y clock_
+     * el estado desde el que sigue el hilo de fondo.
+     * @return true si el log existente se puede seguir usando.
+     */
+    bool recover() {
+        auto t_start = std::chrono::steady_clock::now();
+        LogFileHeader h;
+        std::vector<PriorityRecord> recs;
+        size_t tail = 0;
+        clock_ = static_cast<uint64_t>(trie_.access_counter());
+        bool have_checkpoint = read_file(checkpoint_path_, h, recs, tail);
+        if (have_checkpoint) {
+            if (!valid(h, trie_detail::checkpoint_magic) || recs.size() != h.count || tail != 0) {
+                throw std::runtime_error("PriorityLog: checkpoint inválido o de otra política: " + checkpoint_path_);
+            }
+            generation_ = h.generation;
+            recovery_.checkpoint_records = recs.size();
+            for (const auto& r : recs) latest_[r.id] = r.priority;
+            clock_ = h.access_counter;
+        }
+
+        recs.clear();
+        tail = 0;
+        bool log_usable = false;
+        if (read_file(log_path_, h, recs, tail)) {
+            if (!valid(h, trie_detail::update_log_magic)) {
+                throw std::runtime_error("PriorityLog: log inválido o de otra política: " + log_path_);
+            }
+            if (h.generation == generation_) {
+                log_usable = true;
+                recovery_.log_records = recs.size();
+                for (const auto& r : recs) apply(r);
+                if (tail) {
+                    recovery_.torn_tail = true;
+                    off_t keep = static_cast<off_t>(sizeof(LogFileHeader) + recs.size() * sizeof(PriorityRecord));
+                    if (::truncate(log_path_.c_str(), keep) != 0) {
+                        throw std::runtime_error("PriorityLog: no se pudo recortar " + log_path_);
+                    }
+                }
+            } else {
+                recovery_.stale_log = true;
+            }
+        }
+
+        if (!latest_.empty() || have_checkpoint) {
+            std::unordered_map<uint64_t, Node*> by_id;
+            trie_.for_each_terminal([&](Node* t) {
+                uint64_t id = word_fingerprint(trie_.word(t));
+                auto [it, fresh] = by_id.emplace(id, t);
+                if (id == epoch_mark || (!fresh && trie_.word(it->second) != trie_.word(t))) {
+                    throw std::runtime_error("PriorityLog: dos palabras con la misma huella");
+                }
+            });
+            std::vector<std::pair<Node*, Counter>> restore;
+            restore.reserve(latest_.size());
+            for (const auto& [id, priority] : latest_) {
+                auto it = by_id.find(id);
+                if (it == by_id.end()) {
+                    ++recovery_.unknown;
+                    continue;
+                }
+                restore.emplace_back(it->second, static_cast<Counter>(priority));
+            }
+            recovery_.recomputed =
+                trie_.restore_priorities(restore.begin(), restore.end(), static_cast<Counter>(clock_));
+        }
+        recovery_.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t_start).count();
+        return log_usable;
+    }
+};
@@ -0,0 +1,293 @@
+#pragma once
+#include <cassert>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "string_arena.hpp"
+#include "trie.hpp"
+
+/**
+ * @class RadixTrie
+ * @brief Trie con compresión de caminos (Patricia): las cadenas de nodos con
+ * un solo hijo se fusionan en etiquetas de arista.
+ *
+ * Expone la misma API de autocompletado que Trie. Como un carácter puede caer
+ * a mitad de una arista, descend() trabaja con una Position (nodo + cuántos
+ * caracteres de su etiqueta se han consumido), de modo que la simulación de
+ * tecleo carácter a carácter funciona sin cambios.
+ *
+ * @tparam PriorityPolicy Igual que en Trie (FrequencyPolicy o RecentPolicy).
+ */
+template <typename PriorityPolicy>
+class RadixTrie {
+public:
+    using Counter = typename PriorityPolicy::Counter;
+    using policy_type = PriorityPolicy;
+
+    /**
+     * @struct Node
+     * @brief Nodo con la etiqueta de la arista que llega a él.
+     *
+     * Un nodo es terminal si alguna palabra termina exactamente en él (hace
+     * el papel del hijo '$' del Trie).
+     */
+    struct Node {
+        std::string label;                  // etiqueta de la arista entrante
+        Node* parent = nullptr;
+        std::vector<Node*> children;        // ordenados por label[0]
+        bool is_terminal = false;
+
+        // Metadatos para autocompletar
+        StringArena::Handle str = 0;        // palabra en la arena (si terminal)
+        Counter priority = 0;               // prioridad del nodo terminal
+        Node* best_terminal = nullptr;      // mejor terminal del subárbol
+        Counter best_priority = 0;          // prioridad de ese mejor terminal
+    };
+
+    /**
+     * @struct Position
+     * @brief Cursor de descenso: nodo destino y caracteres consumidos de su
+     * etiqueta. Con offset == label.size() el cursor está sobre el nodo.
+     */
+    struct Position {
+        Node* node = nullptr;
+        uint32_t offset = 0;
+
+        explicit operator bool() const { return node != nullptr; }
+        Node* operator->() const { return node; }
+        bool at_node() const { return node && offset == node->label.size(); }
+    };
+
+    RadixTrie() : node_count_(1), global_access_counter_(0) {
+        nodes_.emplace_back();
+        root_ = &nodes_.back();
+    }
+
+    RadixTrie(const RadixTrie&) = delete;
+    RadixTrie& operator=(const RadixTrie&) = delete;
+
+    /**
+     * Inserta una palabra, partiendo una arista si la palabra diverge a mitad
+     * de su etiqueta.
+     * @param w: palabra a insertar.
+     * Complejidad: O(|w|).
+     * @details Reinsertar la palabra (aunque cambien las mayúsculas) no la
+     * copia y conserva la grafía de la primera inserción.
+     */
+    void insert(const std::string& w) {
+        std::string key = normalize(w);
+        Node* v = root_;
+        size_t i = 0;
+        while (i < key.size()) {
+            Node* u = find_child(v, key[i]);
+            if (!u) {
+                Node* leaf = new_node(v, key.substr(i));
+                add_child(v, leaf);
+                v = leaf;
+                i = key.size();
+                break;
+            }
+            size_t j = 0;
+            while (j < u->label.size() && i + j < key.size() && u->label[j] == key[i + j]) ++j;
+            if (j < u->label.size()) u = split(u, j);
+            v = u;
+            i += j;
+        }
+
+        v->is_terminal = true;
+        if (!v->str) v->str = strings_.add(w);     // conserva la primera grafía, como Trie
+        bubble_up(v);
+    }
+
+    /**
+     * @brief Avanza una posición por el carácter c.
+     * @param p Posición actual.
+     * @param c Carácter por el cual se desciende ('$' pide el terminal).
+     * @return Nueva posición o una Position vacía si no existe.
+     */
+    Position descend(Position p, char c) const {
+        if (!p) return {};
+        if (c == '$') {
+            return (p.at_node() && p.node->is_terminal) ? p : Position{};
+        }
+        int idx = char_to_index(c);
+        if (idx < 0) return {};
+        char x = LowercaseAlphabet::symbol(idx);
+        if (!p.at_node()) {
+            if (p.node->label[p.offset] != x) return {};
+            return {p.node, p.offset + 1};
+        }
+        Node* u = find_child(p.node, x);
+        if (!u) return {};
+        return {u, 1};
+    }
+
+    /**
+     * @brief Retorna el mejor terminal del subárbol bajo la posición.
+     * @details A mitad de una arista todas las palabras pasan por el nodo
+     * destino, así que basta con su best_terminal.
+     */
+    Node* autocomplete(Position p) const {
+        if (!p) return nullptr;
+        return p.node->best_terminal;
+    }
+
+    /**
+     * @brief Actualiza la prioridad de un terminal y propaga hacia la raíz.
+     * @param terminal Posición obtenida con descend(v, '$').
+     * @return Cantidad de nodos visitados durante la propagación.
+     */
+    size_t update_priority(Position terminal) {
+        assert(terminal && terminal.node->is_terminal);
+        PriorityPolicy::touch(terminal.node->priority, global_access_counter_);
+        if constexpr (trie_detail::is_monotonic<PriorityPolicy>::value) {
+            return propagate_increase(terminal.node);
+        } else {
+            return bubble_up(terminal.node);
+        }
+    }
+
+    Position root() const { return {root_, 0}; }
+
+    size_t node_count() const { return node_count_; }
+
+    // Utilidad: desciende por un string prefijo (sin forzar '$')
+    Position descend_prefix(const std::string& pref) const {
+        Position p = root();
+        for (char ch : pref) {
+            p = descend(p, ch);
+            if (!p) return {};
+        }
+        return p;
+    }
+
+    // Palabra guardada en un terminal.
+    std::string_view word(const Node* t) const { return strings_.get(t->str); }
+
+private:
+    std::deque<Node> nodes_;                // almacenamiento estable de nodos
+    Node* root_;
+    size_t node_count_;
+    Counter global_access_counter_;
+    StringArena strings_;
+
+    // Letras del alfabeto de Trie; el fin de palabra no es parte de las etiquetas.
+    static int char_to_index(char c) {
+        int idx = LowercaseAlphabet::index(c);
+        return idx == LowercaseAlphabet::end_index ? -1 : idx;
+    }
+
+    // Deja solo letras en minúscula, igual que las descartadas por Trie::insert.
+    static std::string normalize(const std::string& w) {
+        std::string key;
+        key.reserve(w.size());
+        for (char ch : w) {
+            int idx = char_to_index(ch);
+            if (idx >= 0) key.push_back(LowercaseAlphabet::symbol(idx));
+        }
+        return key;
+    }
+
+    Node* new_node(Node* parent, std::string label) {
+        nodes_.emplace_back();
+        Node* u = &nodes_.back();
+        u->parent = parent;
+        u->label = std::move(label);
+        ++node_count_;
+        return u;
+    }
+
+    static Node* find_child(const Node* v, char c) {
+        for (Node* u : v->children) {
+            if (u->label[0] == c) return u;
+            if (u->label[0] > c) break;
+        }
+        return nullptr;
+    }
+
+    static void add_child(Node* v, Node* u) {
+        auto it = v->children.begin();
+        while (it != v->children.end() && (*it)->label[0] < u->label[0]) ++it;
+        v->children.insert(it, u);
+    }
+
+    /**
+     * @brief Parte la arista de u tras `len` caracteres.
+     * @return El nuevo nodo intermedio, que hereda los metadatos de u.
+     */
+    Node* split(Node* u, size_t len) {
+        Node* parent = u->parent;
+        Node* mid = new_node(parent, u->label.substr(0, len));
+        for (Node*& c : parent->children) {
+            if (c == u) c = mid;
+        }
+        u->label.erase(0, len);
+        u->parent = mid;
+        mid->children.push_back(u);
+        mid->best_terminal = u->best_terminal;
+        mid->best_priority = u->best_priority;
+        return mid;
+    }
+
+    /**
+     * @brief Recalcula el mejor terminal del subárbol de v.
+     * @details Recorre los hijos en orden alfabético y considera el propio
+     * terminal al final y con comparación estricta, igual que el hijo '$'
+     * (índice 26) en Trie, para que los empates se resuelvan de la misma forma.
+     */
+    static void recompute_best(Node* v) {
+        Node* best = nullptr;
+        Counter bestp = 0;
+        for (Node* u : v->children) {
+            if (u->best_terminal && u->best_priority > bestp) {
+                best = u->best_terminal;
+                bestp = u->best_priority;
+            }
+        }
+        if (v->is_terminal && v->priority > bestp) {
+            best = v;
+            bestp = v->priority;
+        }
+        v->best_terminal = best;
+        v->best_priority = bestp;
+    }
+
+    static size_t bubble_up(Node* from) {
+        size_t visited = 0;
+        for (Node* v = from; v; v = v->parent) {
+            recompute_best(v);
+            ++visited;
+        }
+        return visited;
+    }
+
+    /**
+     * @brief Propagación incremental para políticas monótonas (ver Trie).
+     * @details A diferencia del Trie, el terminal puede tener hijos, así que
+     * el propio terminal se trata como el primer ancestro.
+     */
+    static size_t propagate_increase(Node* t) {
+        const Counter p = t->priority;
+        size_t visited = 0;
+        for (Node* v = t; v; v = v->parent) {
+            ++visited;
+            if (v->best_terminal == t) {
+                if (v->best_priority == p) break;
+                v->best_priority = p;
+            } else if (p > v->best_priority) {
+                v->best_terminal = t;
+                v->best_priority = p;
+            } else if (p == v->best_priority) {
+                Node* before = v->best_terminal;
+                recompute_best(v);
+                if (v->best_terminal == before) break;
+            } else {
+                break;
+            }
+        }
+        return visited;
+    }
+};
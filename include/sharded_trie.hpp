@@ -0,0 +1,207 @@
+#pragma once
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "trie.hpp"
+
+/**
+ * @class ShardedTrie
+ * @brief Reparte las palabras entre varios Tries ("shards") según sus
+ * primeras letras, para que los escritores de distintos shards no compitan
+ * por la misma raíz.
+ *
+ * Con la configuración por defecto (26 shards, 1 carácter) cada shard es el
+ * subárbol de una letra. Cada shard tiene su propio mutex de escritura y su
+ * propio contador de accesos. Las políticas que leen el contador global
+ * (RecentPolicy) reciben timestamps de un reloj atómico compartido, de modo
+ * que las prioridades de distintos shards siguen siendo comparables y la
+ * sugerencia para un prefijo corto se obtiene mezclando los mejores de cada
+ * shard.
+ *
+ * Si los shards usan ThreadSafe, las lecturas no toman el mutex del shard y
+ * las escrituras usan solo el del propio Trie (ver write()).
+ *
+ * @tparam PriorityPolicy Política de prioridad.
+ * @tparam Options Opciones de cada shard (p.ej. ArenaStorage, ThreadSafe).
+ */
+template <typename PriorityPolicy, typename... Options>
+class ShardedTrie {
+public:
+    using Shard = Trie<PriorityPolicy, Options...>;
+    using Node = typename Shard::Node;
+    using Counter = typename PriorityPolicy::Counter;
+    using policy_type = PriorityPolicy;
+
+    /**
+     * @param shard_count Cantidad de shards.
+     * @param key_chars Cuántas letras iniciales deciden el shard.
+     */
+    explicit ShardedTrie(size_t shard_count = 26, size_t key_chars = 1)
+        : key_chars_(key_chars) {
+        assert(shard_count > 0 && key_chars > 0);
+        for (size_t i = 0; i < shard_count; ++i) slots_.emplace_back(new Slot());
+    }
+
+    void insert(const std::string& w) {
+        Slot& s = slot_for(w);
+        write<false>(s, [&] { s.trie.insert(w); });
+    }
+
+    /**
+     * @brief Registra un uso de la palabra w.
+     * @return false si la palabra no está en el trie.
+     */
+    bool update(const std::string& w) {
+        Slot& s = slot_for(w);
+        return write<shared_clock>(s, [&] {
+            Node* t = s.trie.descend(s.trie.descend_prefix(w), '$');
+            if (!t) return false;
+            s.accesses.fetch_add(1, std::memory_order_relaxed);
+            if constexpr (shared_clock) {
+                Counter stamp = clock_.fetch_add(1, std::memory_order_relaxed);
+                s.trie.update_priority(t, stamp);
+            } else {
+                s.trie.update_priority(t);
+            }
+            return true;
+        });
+    }
+
+    /**
+     * @brief Mejor palabra para el prefijo dado (vacía si no hay ninguna).
+     * @details Si el prefijo alcanza para decidir el shard se consulta solo
+     * ese; si es más corto se mezclan los mejores de todos los shards. Como
+     * shard_index no sigue el orden de las letras, los empates se resuelven
+     * comparando las palabras (precedes), así que se elige la misma que
+     * recompute_best en un solo Trie.
+     * La vista apunta a la arena de strings del shard.
+     */
+    std::string_view autocomplete(const std::string& prefix) const {
+        std::string key = shard_key(prefix);
+        if (key.size() >= key_chars_) {
+            const Slot& s = *slots_[shard_index(key)];
+            return read(s, [&] {
+                Node* t = s.trie.autocomplete(s.trie.descend_prefix(prefix));
+                return t ? s.trie.word(t) : std::string_view{};
+            });
+        }
+        std::string_view best;
+        Counter bestp = 0;
+        for (const auto& slot : slots_) {
+            const Slot& s = *slot;
+            read(s, [&] {
+                auto [t, p] = s.trie.autocomplete_with_priority(s.trie.descend_prefix(prefix));
+                if (!t || p < bestp || p == 0) return;
+                std::string_view w = s.trie.word(t);
+                if (p > bestp || precedes(w, best)) {
+                    best = w;
+                    bestp = p;
+                }
+            });
+        }
+        return best;
+    }
+
+    size_t shard_count() const { return slots_.size(); }
+
+    // Accesos registrados por el shard i.
+    uint64_t shard_accesses(size_t i) const { return slots_[i]->accesses.load(std::memory_order_relaxed); }
+
+    size_t node_count() const {
+        size_t total = 0;
+        for (const auto& s : slots_) total += s->trie.node_count();
+        return total;
+    }
+
+private:
+    // Cada shard en su propia línea de caché para no compartir escrituras.
+    struct alignas(64) Slot {
+        Shard trie;
+        mutable std::mutex lock;
+        std::atomic<uint64_t> accesses{0};
+    };
+
+    // Las políticas que leen el contador reciben el reloj compartido.
+    static constexpr bool shared_clock = trie_detail::uses_access_counter<PriorityPolicy>::value;
+
+    std::vector<std::unique_ptr<Slot>> slots_;
+    size_t key_chars_;
+    alignas(64) std::atomic<Counter> clock_{0};
+
+    // Lee sin bloqueo si el shard es ThreadSafe; si no, bajo su mutex.
+    template <typename F>
+    static auto read(const Slot& s, F&& f) {
+        if constexpr (Shard::thread_safe) {
+            return f();
+        } else {
+            std::lock_guard<std::mutex> guard(s.lock);
+            return f();
+        }
+    }
+
+    /**
+     * @brief Escribe en el shard bajo el mutex del slot, salvo que el shard
+     * sea ThreadSafe: entonces su propio mutex ya serializa a los escritores.
+     * @tparam ClockOrder Con el reloj compartido el mutex del slot se toma
+     * igual: el timestamp se lee antes de entrar al Trie, y sin él dos usos
+     * del mismo shard podrían aplicarse en orden inverso al de sus
+     * timestamps (una prioridad de RecentPolicy bajaría).
+     */
+    template <bool ClockOrder, typename F>
+    static auto write(Slot& s, F&& f) {
+        if constexpr (Shard::thread_safe && !ClockOrder) {
+            return f();
+        } else {
+            std::lock_guard<std::mutex> guard(s.lock);
+            return f();
+        }
+    }
+
+    // Orden de las palabras que sigue recompute_best en un Trie: símbolo a
+    // símbolo por índice del alfabeto, con el fin de palabra después de todos.
+    static bool precedes(std::string_view a, std::string_view b) {
+        size_t i = 0, j = 0;
+        for (;;) {
+            int x = next_symbol(a, i), y = next_symbol(b, j);
+            if (x != y) return x < y;
+            if (x == Shard::Alphabet::end_index) return false;
+        }
+    }
+
+    // Índice del siguiente símbolo que el Trie guarda (end_index al terminar).
+    static int next_symbol(std::string_view w, size_t& i) {
+        using Alphabet = typename Shard::Alphabet;
+        while (i < w.size()) {
+            int idx = Alphabet::index(w[i++]);
+            if (idx >= 0 && idx != Alphabet::end_index) return idx;
+        }
+        return Alphabet::end_index;
+    }
+
+    // Primeros key_chars símbolos válidos, en su forma canónica (los que usa el Trie).
+    std::string shard_key(const std::string& w) const {
+        using Alphabet = typename Shard::Alphabet;
+        std::string key;
+        for (char ch : w) {
+            if (key.size() == key_chars_) break;
+            int idx = Alphabet::index(ch);
+            if (idx >= 0 && idx != Alphabet::end_index) key.push_back(Alphabet::symbol(idx));
+        }
+        return key;
+    }
+
+    size_t shard_index(const std::string& key) const {
+        using Alphabet = typename Shard::Alphabet;
+        size_t h = 0;
+        for (char c : key) h = h * Alphabet::end_index + static_cast<size_t>(Alphabet::index(c));
+        return h % slots_.size();
+    }
+
+    Slot& slot_for(const std::string& w) { return *slots_[shard_index(shard_key(w))]; }
+};
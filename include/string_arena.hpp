@@ -0,0 +1,150 @@
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <utility>
+
+#include "node_store.hpp"
+
+/**
+ * @class StringArena
+ * @brief Palabras guardadas una tras otra en bloques contiguos, cada una
+ * precedida por su largo (varint), y referidas por handles de 32 bits.
+ *
+ * Un handle es (bloque << chunk_bits) | desplazamiento. El primer byte de la
+ * arena queda reservado para que el handle 0 sea nulo. Una palabra que no cabe
+ * en un bloque normal recibe un bloque propio de su tamaño. Los bloques nunca
+ * se mueven, así que las string_view entregadas siguen siendo válidas mientras
+ * viva la arena, y get() puede ejecutarse en paralelo con add().
+ *
+ * Como Store::Local, Local le da a cada hilo bloques propios para agregar
+ * palabras sin sincronizarse con los demás.
+ */
+class StringArena {
+    // Bloque en uso y próxima posición libre dentro de él.
+    struct Cursor {
+        size_t chunk = 0;
+        size_t pos = 0;
+        size_t end = 0;
+    };
+
+public:
+    using Handle = uint32_t;
+    static constexpr unsigned chunk_bits = 16;
+    static constexpr size_t chunk_size = size_t(1) << chunk_bits;
+
+    StringArena() { clear(); }
+    StringArena(const StringArena&) = delete;
+    StringArena& operator=(const StringArena&) = delete;
+
+    // Copia w a la arena y retorna su handle.
+    Handle add(std::string_view w) { return append(cursor_, w, [this](size_t bytes) { return grow(bytes); }); }
+
+    std::string_view get(Handle h) const {
+        if (!h) return {};
+        const unsigned char* p =
+            reinterpret_cast<const unsigned char*>(chunks_[h >> chunk_bits]) + (h & (chunk_size - 1));
+        size_t len = 0;
+        for (unsigned shift = 0;; shift += 7) {
+            len |= size_t(*p & 0x7F) << shift;
+            if (!(*p++ & 0x80)) break;
+        }
+        return {reinterpret_cast<const char*>(p), len};
+    }
+
+    // Bytes reservados en bloques (incluye lo que aún no se usa).
+    size_t bytes_used() const { return bytes_; }
+
+    void swap(StringArena& o) {
+        chunks_.swap(o.chunks_);
+        std::swap(bytes_, o.bytes_);
+        std::swap(cursor_, o.cursor_);
+    }
+
+    void clear() {
+        chunks_.clear();
+        bytes_ = 0;
+        cursor_.chunk = grow(0);
+        cursor_.pos = 1;            // handle 0 = nulo
+        cursor_.end = chunk_size;
+    }
+
+    // Asignador de un hilo: llena bloques propios pedidos a la arena.
+    class Local {
+    public:
+        explicit Local(StringArena& arena) : arena_(&arena) {}
+
+        Handle add(std::string_view w) {
+            return arena_->append(cursor_, w, [this](size_t bytes) { return arena_->take_chunk(bytes); });
+        }
+
+    private:
+        StringArena* arena_;
+        Cursor cursor_;
+    };
+
+    Local local() { return Local(*this); }
+
+private:
+    trie_detail::SlabDirectory<char> chunks_;
+    size_t bytes_ = 0;
+    Cursor cursor_;
+    std::mutex grow_mutex_;         // serializa take_chunk()
+
+    static size_t varint_size(size_t n) {
+        size_t k = 1;
+        while (n >= 0x80) {
+            n >>= 7;
+            ++k;
+        }
+        return k;
+    }
+
+    // Agrega un bloque de al menos `bytes` y retorna su posición.
+    size_t grow(size_t bytes) {
+        size_t size = bytes > chunk_size ? bytes : chunk_size;
+        bytes_ += size;
+        size_t chunk = chunks_.add(std::unique_ptr<char[]>(new char[size]));
+        assert(chunk < (size_t(1) << (32 - chunk_bits)) && "StringArena: demasiados bloques");
+        return chunk;
+    }
+
+    size_t take_chunk(size_t bytes) {
+        std::lock_guard<std::mutex> guard(grow_mutex_);
+        return grow(bytes);
+    }
+
+    template <typename Grow>
+    Handle append(Cursor& c, std::string_view w, Grow&& new_chunk) {
+        size_t need = varint_size(w.size()) + w.size();
+        if (c.pos + need > c.end) {
+            if (need > chunk_size) {
+                // Bloque propio; el cursor sigue en su bloque actual
+                size_t big = new_chunk(need);
+                write(chunks_[big], w);
+                return static_cast<Handle>(big << chunk_bits);
+            }
+            c.chunk = new_chunk(chunk_size);
+            c.pos = 0;
+            c.end = chunk_size;
+        }
+        Handle h = static_cast<Handle>((c.chunk << chunk_bits) | c.pos);
+        write(chunks_[c.chunk] + c.pos, w);
+        c.pos += need;
+        return h;
+    }
+
+    static void write(char* dst, std::string_view w) {
+        size_t n = w.size();
+        while (n >= 0x80) {
+            *dst++ = static_cast<char>((n & 0x7F) | 0x80);
+            n >>= 7;
+        }
+        *dst++ = static_cast<char>(n);
+        std::memcpy(dst, w.data(), w.size());
+    }
+};
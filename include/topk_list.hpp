@@ -0,0 +1,76 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// --- Candidatos top-k por nodo ---------------------------------------------
+
+// Marca común para que el Trie reconozca la opción de top-k.
+struct TopKOption {};
+
+/**
+ * @brief Guarda en cada nodo los K mejores terminales de su subárbol.
+ * @details TopK<0> (por defecto) desactiva las listas y no agrega memoria.
+ */
+template <size_t K>
+struct TopK : TopKOption {
+    static_assert(K < 256, "TopK usa un contador de 8 bits");
+    static constexpr size_t value = K;
+};
+
+/**
+ * @class TopKList
+ * @brief Lista acotada de K candidatos ordenada por prioridad descendente.
+ *
+ * Los enlaces y las prioridades se guardan en arreglos separados para no
+ * pagar relleno de alineación. Ante empates se conserva el candidato ofrecido
+ * primero, igual que el desempate por orden de hijos de recompute_best.
+ */
+template <typename Link, typename Counter, size_t K>
+struct TopKList {
+    std::array<Link, K> terminal{};
+    std::array<Counter, K> priority{};
+    uint8_t size = 0;
+
+    /**
+     * @brief Ofrece un candidato a la lista.
+     * @return false si la lista está llena y el candidato no supera al último;
+     * como las listas de los hijos están ordenadas, el resto tampoco entra.
+     */
+    bool offer(Link t, Counter p) {
+        if (size == K && !(p > priority[K - 1])) return false;
+        size_t pos = (size == K) ? K - 1 : size;
+        while (pos > 0 && priority[pos - 1] < p) {
+            terminal[pos] = terminal[pos - 1];
+            priority[pos] = priority[pos - 1];
+            --pos;
+        }
+        terminal[pos] = t;
+        priority[pos] = p;
+        if (size < K) ++size;
+        return true;
+    }
+
+    bool operator==(const TopKList& o) const {
+        if (size != o.size) return false;
+        for (size_t i = 0; i < size; ++i) {
+            if (terminal[i] != o.terminal[i] || priority[i] != o.priority[i]) return false;
+        }
+        return true;
+    }
+    bool operator!=(const TopKList& o) const { return !(*this == o); }
+};
+
+namespace trie_detail {
+// Base del nodo: vacía (sin costo por EBO) cuando K == 0.
+struct NoTopK {};
+
+template <typename Link, typename Counter, size_t K>
+struct WithTopK {
+    TopKList<Link, Counter, K> top;     // K mejores terminales del subárbol
+};
+
+template <typename Link, typename Counter, size_t K>
+using topk_base_t = std::conditional_t<(K > 0), WithTopK<Link, Counter, K>, NoTopK>;
+} // namespace trie_detail
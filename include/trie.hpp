@@ -1,18 +1,43 @@
 #pragma once
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
-#include <cctype>
+#include <cmath>
 #include <cstdint>
+#include <limits>
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 #include <vector>
-#include <deque>
+#include <iterator>
+#include <thread>
+
+#include "alphabet.hpp"
+#include "node_children.hpp"
+#include "node_store.hpp"
+#include "string_arena.hpp"
+#include "topk_list.hpp"
+#include "trie_propagation.hpp"
+#include "trie_stats.hpp"
+#include "prefix_cache.hpp"
+#include "trie_sync.hpp"
 
 // --- Políticas de prioridad -----------------------------------------------
+// Una política es monótona (monotonic = true) si touch() nunca disminuye la
+// prioridad del terminal; el Trie usa entonces una propagación incremental que
+// se detiene en el primer ancestro que no cambia. uses_access_counter indica
+// si touch() lee el contador global (lo necesitan estructuras que reparten
+// ese contador entre varios Tries).
+
 // Frecuencia: priority = cantidad de accesos al nodo terminal
 struct FrequencyPolicy {
     using Counter = uint64_t;
+    static constexpr bool monotonic = true;
+    static constexpr bool uses_access_counter = false;
     static inline const char* name() { return "frequency"; }
     static void touch(Counter& node_priority, Counter& /*global_access_counter*/) {
         ++node_priority;
@@ -22,14 +47,128 @@ struct FrequencyPolicy {
 // Reciente: priority = timestamp creciente (contador global de accesos)
 struct RecentPolicy {
     using Counter = uint64_t;
+    static constexpr bool monotonic = true;
+    static constexpr bool uses_access_counter = true;
     static inline const char* name() { return "recent"; }
     static void touch(Counter& node_priority, Counter& global_access_counter) {
         node_priority = ++global_access_counter;
     }
 };
 
+// Frecencia: puntaje con decaimiento exponencial; cada uso pesa el doble que
+// uno de HalfLife accesos atrás. La clave es log2 del puntaje en punto fijo
+// (frac_bits bits de fracción), medido desde una época que avanza: el paso del
+// tiempo escala todos los puntajes por igual y no cambia su orden, así que
+// comparar claves es comparar puntajes ya decaídos, la clave solo sube con
+// cada uso (monótona) y no hay que recorrer el trie para envejecerla. El reloj
+// es el contador global de accesos; cuando llega a 2 * epoch_ticks el Trie
+// adelanta la época y reexpresa todas las claves (Trie::renormalize), lo que
+// las mantiene bajo 2^31, dentro del par empaquetado de ThreadSafe.
+template <uint32_t HalfLife = 1024>
+struct FrecencyPolicy {
+    static_assert(HalfLife >= 1 && HalfLife <= (1u << 17), "HalfLife fuera de rango: 2 * epoch_ticks debe caber en 32 bits");
+    using Counter = uint32_t;
+    static constexpr bool monotonic = true;
+    static constexpr bool uses_access_counter = true;
+    static constexpr int frac_bits = 16;
+    static constexpr uint32_t epoch_halvings = 1u << 13;            // medias vidas por época
+    static constexpr Counter epoch_ticks = HalfLife * epoch_halvings;
+    static constexpr Counter epoch_shift = epoch_halvings << frac_bits;
+    static inline const char* name() { return "frecency"; }
+
+    // key = epoch_shift + log2(puntaje) * 2^frac_bits; 0 = nunca usado, 1 = el
+    // uso más reciente fue hace más de epoch_halvings medias vidas.
+    static void touch(Counter& key, Counter& clock) {
+        constexpr double scale = double(1u << frac_bits);
+        if (clock < std::numeric_limits<Counter>::max()) ++clock;
+        const double a = double(clock) / HalfLife;      // log2 del aporte de este uso
+        double k = a;
+        if (key) {
+            const double old = (double(key) - epoch_shift) / scale;
+            k = std::max(old, a) + std::log2(1.0 + std::exp2(-std::fabs(old - a)));
+        }
+        double x = std::min(epoch_shift + k * scale, double(std::numeric_limits<Counter>::max()));
+        key = std::max(key, std::max<Counter>(1, static_cast<Counter>(std::llround(x))));
+    }
+
+    // El reloj llegó al final de la época y hay que renormalizar.
+    static bool epoch_full(Counter clock) { return clock >= 2 * epoch_ticks; }
+
+    // Adelanta la época epoch_ticks accesos.
+    static void advance(Counter& clock) { clock -= epoch_ticks; }
+
+    // Clave en el marco de la época siguiente (resta epoch_halvings medias vidas).
+    static Counter rebase(Counter key) {
+        if (key == 0) return 0;
+        return key > epoch_shift ? key - epoch_shift : 1;
+    }
+};
+
+// Fuerza el recálculo completo hasta la raíz (útil para comparar).
+template <typename Policy>
+struct FullRecompute : Policy {
+    static constexpr bool monotonic = false;
+};
+
+// --- Opciones del Trie -----------------------------------------------------
+// Las opciones se pasan después de la política en cualquier orden, p.ej.
+// Trie<FrequencyPolicy, ArenaStorage>. Cada categoría tiene una marca base y
+// un valor por defecto.
+namespace trie_detail {
+template <typename Category, typename Default, typename... Options>
+struct select_option { using type = Default; };
+
+template <typename Category, typename Default, typename First, typename... Rest>
+struct select_option<Category, Default, First, Rest...> {
+    using type = std::conditional_t<std::is_base_of_v<Category, First>, First,
+                 typename select_option<Category, Default, Rest...>::type>;
+};
+
+template <typename Category, typename Default, typename... Options>
+using select_option_t = typename select_option<Category, Default, Options...>::type;
+
+// Políticas sin el rasgo `monotonic` se tratan como no monótonas.
+template <typename Policy, typename = void>
+struct is_monotonic : std::false_type {};
+
+template <typename Policy>
+struct is_monotonic<Policy, std::void_t<decltype(Policy::monotonic)>>
+    : std::bool_constant<Policy::monotonic> {};
+
+// Ante la duda, se asume que la política usa el contador global.
+template <typename Policy, typename = void>
+struct uses_access_counter : std::true_type {};
+
+template <typename Policy>
+struct uses_access_counter<Policy, std::void_t<decltype(Policy::uses_access_counter)>>
+    : std::bool_constant<Policy::uses_access_counter> {};
+
+// Políticas con época móvil (ver FrecencyPolicy): el Trie las renormaliza.
+template <typename Policy, typename = void>
+struct renormalizes : std::false_type {};
+
+template <typename Policy>
+struct renormalizes<Policy, std::void_t<decltype(Policy::epoch_full(typename Policy::Counter{}))>>
+    : std::true_type {};
+
+// Recorre un rango de punteros entregando las referencias apuntadas.
+template <typename It>
+struct DerefIterator {
+    It it;
+    decltype(auto) operator*() const { return **it; }
+    DerefIterator& operator++() {
+        ++it;
+        return *this;
+    }
+    bool operator!=(const DerefIterator& o) const { return it != o.it; }
+};
+
+template <typename It>
+DerefIterator<It> deref_iterator(It it) { return {it}; }
+} // namespace trie_detail
+
 // --- Trie parametrizado por la Política ------------------------------------
-template <typename PriorityPolicy>
+template <typename PriorityPolicy, typename... Options>
 
 /**
  * @class Trie
@@ -37,73 +176,286 @@ template <typename PriorityPolicy>
  *
  * @tparam PriorityPolicy Define cómo se calcula y actualiza la prioridad
  * (por frecuencia o por recencia).
+ * @tparam Options Opciones de configuración: almacenamiento (HeapStorage o
+ * ArenaStorage), representación de hijos (DenseLayout o SparseLayout),
+ * listas de candidatos por nodo (TopK<K>), concurrencia (ThreadSafe),
+ * momento de la propagación (DeferredPropagation<N>), alfabeto
+ * (LowercaseAlphabet, AlphanumericAlphabet o Utf8ByteAlphabet),
+ * instrumentación (CollectStats) y tabla de prefijos cortos (PrefixCache<D>).
  */
 class Trie {
 public:
     using Counter = typename PriorityPolicy::Counter;
+    using policy_type = PriorityPolicy;
+    using Storage = trie_detail::select_option_t<StorageOption, HeapStorage, Options...>;
+    using Layout = trie_detail::select_option_t<ChildrenOption, DenseLayout, Options...>;
+    static constexpr size_t topk = trie_detail::select_option_t<TopKOption, TopK<0>, Options...>::value;
+    using Sync = trie_detail::select_option_t<SyncOption, SingleThreaded, Options...>;
+    static constexpr bool thread_safe = Sync::enabled;
+    using Propagation = trie_detail::select_option_t<PropagationOption, ImmediatePropagation, Options...>;
+    using Alphabet = trie_detail::select_option_t<AlphabetOption, LowercaseAlphabet, Options...>;
+    using Instrumentation = trie_detail::select_option_t<InstrumentationOption, NoStats, Options...>;
+    static constexpr bool collect_stats = Instrumentation::enabled;
+    static constexpr size_t prefix_cache_depth =
+        trie_detail::select_option_t<PrefixCacheOption, NoPrefixCache, Options...>::depth;
+
+    static_assert(!thread_safe || std::is_same_v<Layout, DenseLayout>,
+                  "ThreadSafe requiere DenseLayout: SparseLayout reubica los hijos al crecer");
+    static_assert(!thread_safe || topk == 0,
+                  "ThreadSafe no admite TopK: las listas no se publican atómicamente");
+    static_assert(!thread_safe || !collect_stats,
+                  "ThreadSafe no admite CollectStats: los contadores no son atómicos");
+    static_assert(!thread_safe || prefix_cache_depth == 0,
+                  "ThreadSafe no admite PrefixCache: las entradas no se publican atómicamente");
+
+    struct Node;
+    // Enlace entre nodos: Node* con HeapStorage, índice de 32 bits con ArenaStorage.
+    using Link = typename Storage::template link_type<Node>;
+    // Σ lo fija el alfabeto (27 por defecto: 'a'..'z' y '$' como fin de palabra)
+    static constexpr size_t sigma = Alphabet::size;
+    using Children = std::conditional_t<thread_safe, DenseChildren<Link, sigma, true>,
+                                        typename Layout::template type<Link, sigma>>;
 
     /**
     * @struct Node
     * @brief Representa un nodo del Trie.
     *
-    * Contiene punteros a hijos, un puntero al nodo padre, información sobre si es
+    * Contiene enlaces a hijos, un enlace al nodo padre, información sobre si es
     * terminal y metadatos para determinar el mejor autocompletado dentro del subárbol.
+    * El par (best_terminal, best_priority) se hereda y se accede con
+    * load_best()/store_best(); en modo ThreadSafe va empaquetado en una palabra
+    * atómica. Con TopK<K> hereda además la lista `top` de los K mejores terminales.
     */
-    struct Node {
-        Node* parent = nullptr;
-        // Σ = 27: 'a'..'z' y '$' como fin de palabra
-        std::array<Node*, 27> next{};
-        bool is_terminal = false;
-
+    struct Node : trie_detail::best_base_t<Sync, Link, Counter>,
+                  trie_detail::topk_base_t<Link, Counter, topk> {
         // Metadatos para autocompletar
-        const std::string* str = nullptr;   // puntero al string de la palabra (si terminal)
+        StringArena::Handle str = 0;        // palabra en la arena de strings (si terminal)
         Counter priority = 0;               // prioridad del nodo terminal
-        Node* best_terminal = nullptr;      // mejor terminal del subárbol
-        Counter best_priority = 0;          // prioridad de ese mejor terminal
 
-        Node() { next.fill(nullptr); }
+        Link parent{};
+        Children next;                      // hijos por índice de carácter
+        bool is_terminal = false;
+        bool dirty = false;                 // pendiente de recalcular (DeferredPropagation)
     };
 
-    Trie(): root_(new Node()), node_count_(1), global_access_counter_(0) {}
+    using Store = typename Storage::template store_type<Node>;
+
+    Trie(): root_(store_.create()), node_count_(1), global_access_counter_(0) { rebuild_prefix_cache(); }
 
-    ~Trie() { clear(root_); }
+    Trie(const Trie&) = delete;
+    Trie& operator=(const Trie&) = delete;
+
+    ~Trie() { store_.release(root_); }
 
     /**
     * Inserta una palabra en el trie carácter a carácter.
     * @param w: palabra a insertar.
     * Complejidad: O(|w|).
+    * @details Si la palabra ya estaba no se guarda otra copia; se conserva la
+    * grafía de la primera inserción.
     */
     void insert(const std::string& w) {
-        Node* v = root_;
+        std::lock_guard<Lock> guard(write_mutex_);
+        SerialSink sink{*this};
+        Link v = root_;
         for (char ch : w) {
             int idx = char_to_index(ch);
             if (idx < 0) continue;
-            if (!v->next[idx]) {
-                v->next[idx] = new Node();
-                v->next[idx]->parent = v;
-                ++node_count_;
-            }
-            v = v->next[idx];
+            v = child_or_create(sink, v, idx);
         }
-        // Marca fin de palabra con '$'
-        int end = end_index();
-        if (!v->next[end]) {
-            v->next[end] = new Node();
-            v->next[end]->parent = v;
-            ++node_count_;
+        size_t visited = bubble_up(add_terminal(sink, v, w));
+        count([&](TrieStats& s) { s.note_propagation(visited); });
+        refresh_prefix_cache(w);
+    }
+
+    /**
+     * @brief Elimina una palabra del trie.
+     * @param w Palabra a eliminar; como en insert, se ignoran los caracteres
+     * que no son letras.
+     * @return true si la palabra estaba en el trie.
+     * @details Quita su terminal y los ancestros que quedan sin hijos, y los
+     * devuelve a la lista libre del almacén (la próxima inserción los
+     * reutiliza). Luego recalcula best_* desde el nodo más profundo que
+     * sobrevive y se detiene en el primer ancestro cuyo mejor no cambia (con
+     * TopK, cuya lista no cambia). La palabra sigue ocupando su lugar en la
+     * arena de strings hasta el próximo compact(). Los Node* y Cursor que
+     * apunten a nodos eliminados quedan inválidos.
+     * Complejidad: O(|w|).
+     */
+    bool erase(const std::string& w) {
+        static_assert(!thread_safe, "erase no admite ThreadSafe: un lector podría estar en un nodo liberado");
+        std::vector<Link> path{root_};      // path[d]: nodo a profundidad d
+        std::vector<int> idx;               // idx[d]: índice de path[d + 1] en path[d]
+        for (char ch : w) {
+            int c = char_to_index(ch);
+            if (c < 0) continue;
+            Link u = store_.get(path.back())->next.get(c);
+            if (!u) return false;
+            path.push_back(u);
+            idx.push_back(c);
         }
-        Node* term = v->next[end];
-        term->is_terminal = true;
+        Link dead = store_.get(path.back())->next.get(end_index());
+        if (!dead) return false;
+        if (store_.get(dead)->dirty) dirty_.erase(std::find(dirty_.begin(), dirty_.end(), dead));
+        idx.push_back(end_index());
 
-        // Guardamos el string 
-        strings_.emplace_back(w);
-        term->str = &strings_.back();
+        // Poda hacia arriba mientras el nodo quede sin hijos
+        while (true) {
+            child_bytes_ -= store_.get(path.back())->next.erase(idx.back());
+            store_.destroy(dead);
+            --node_count_;
+            idx.pop_back();
+            if (path.size() == 1 || !store_.get(path.back())->next.empty()) break;
+            dead = path.back();
+            path.pop_back();
+        }
+        repair_from(path.back());
+        refresh_prefix_cache(w);
+        return true;
+    }
 
-        // Inicializamos prioridad en 0
-        if (term->priority == 0) term->priority = 0;
+    /**
+     * @brief Reubica los nodos vivos en un almacén nuevo, en orden DFS.
+     * @return Bytes liberados entre nodos, hijos y arena de strings.
+     * @details Copia cada nodo al visitarlo en preorden (hijos en orden de
+     * índice), así que con ArenaStorage cada subárbol queda contiguo y
+     * desaparecen la lista libre y los huecos que dejaron erase() y
+     * build_parallel. Las palabras se copian en el mismo orden a una arena
+     * nueva, sin las de terminales eliminados. Prioridades, best_* y listas
+     * top-k se conservan (ver copy_nodes).
+     * Las propagaciones pendientes (DeferredPropagation) se aplican antes.
+     * Invalida todos los Node* y Cursor.
+     * Complejidad: O(nodos).
+     */
+    size_t compact() {
+        static_assert(!thread_safe, "compact no admite ThreadSafe: los lectores usan los nodos viejos");
+        std::lock_guard<Lock> guard(write_mutex_);
+        if constexpr (Propagation::deferred) flush_dirty();
+        size_t before = bytes_used() + strings_.bytes_used();
+
+        Store fresh;
+        StringArena words;
+        size_t child_bytes = 0;
+        Link root = copy_nodes(fresh, words, child_bytes, false);
+
+        store_.release(root_);
+        store_.swap(fresh);
+        strings_.swap(words);
+        root_ = root;
+        child_bytes_ = child_bytes;
+        rebuild_prefix_cache();
+        return before - (bytes_used() + strings_.bytes_used());
+    }
+
+    /**
+     * @brief Copia independiente del trie: mismas palabras, prioridades,
+     * best_*, listas top-k y contador de accesos.
+     * @details Copia los nodos en preorden como compact() (sin volver a
+     * insertar ni a calcular best_*), así que la copia queda compacta y
+     * responde y evoluciona igual que el original, empates incluidos. Sirve
+     * para construir un trie una vez y repetir experimentos sobre copias.
+     * Usa `parent` de los nodos de origen como tabla de traducción y lo
+     * restaura al terminar, así que no debe correr junto con otro escritor
+     * del mismo trie. Aplica antes las propagaciones pendientes.
+     * Complejidad: O(nodos).
+     */
+    Trie clone() {
+        static_assert(!thread_safe, "clone no admite ThreadSafe: copia los nodos sin publicarlos");
+        return Trie(CloneTag{}, *this);
+    }
+
+    /**
+     * @brief Carga en bloque una secuencia de palabras ordenada.
+     * @param first, last Rango de palabras (std::string), idealmente ordenado.
+     * @details Recorre las palabras de izquierda a derecha manteniendo el camino
+     * de la anterior: solo se crean nodos a partir del prefijo común. Cuando
+     * un nodo sale del camino su subárbol ya está completo, y recién entonces
+     * se calcula su best_* (una vez por nodo, de abajo hacia arriba), en vez
+     * de propagar hasta la raíz en cada palabra. Con la entrada ordenada los
+     * nodos nacen en orden DFS, contiguos en la arena. El resultado es el
+     * mismo que con insert() palabra a palabra, incluso si el trie no estaba
+     * vacío o la entrada no está ordenada (solo se pierde localidad).
+     * Complejidad: O(total de caracteres).
+     */
+    template <typename It>
+    void build_from_sorted(It first, It last) {
+        std::lock_guard<Lock> guard(write_mutex_);
+        SerialSink sink{*this};
+        build_run(sink, first, last);
+        recompute_best(root_);
+        rebuild_prefix_cache();
+    }
+
+    template <typename Range>
+    void build_from_sorted(const Range& words) {
+        build_from_sorted(std::begin(words), std::end(words));
+    }
+
+    /**
+     * @brief Carga una lista de palabras usando varios hilos.
+     * @param words Palabras en el orden en que se insertarían con insert().
+     * @param threads Cantidad de hilos (0 = std::thread::hardware_concurrency()).
+     * @details Reparte las palabras según su primera letra; el hilo principal
+     * crea los hijos de la raíz y cada hilo construye subárboles completos con
+     * build_from_sorted, tomando nodos de su propio asignador (bloques propios
+     * en la arena). Cada subárbol queda con sus best_* calculados por el hilo
+     * que lo construyó, así que al final solo falta recalcular la raíz. Dentro
+     * de cada letra se respeta el orden de entrada, por lo que el resultado es
+     * el mismo árbol que insertar `words` en orden con insert().
+     */
+    void build_parallel(const std::vector<std::string>& words, unsigned threads = 0) {
+        std::lock_guard<Lock> guard(write_mutex_);
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+        // Cubetas por primer símbolo; las palabras sin símbolos van a la raíz.
+        std::array<std::vector<const std::string*>, Alphabet::end_index> buckets;
+        SerialSink serial{*this};
+        for (const auto& w : words) {
+            int first = -1;
+            for (char ch : w) {
+                if ((first = char_to_index(ch)) >= 0) break;
+            }
+            if (first < 0) {
+                recompute_best(add_terminal(serial, root_, w));
+                continue;
+            }
+            buckets[first].push_back(&w);
+        }
+        for (int c = 0; c < Alphabet::end_index; ++c) {
+            if (!buckets[c].empty()) child_or_create(serial, root_, c);
+        }
 
-        bubble_up(term);
+        // Las letras más cargadas se reparten primero.
+        std::vector<int> order;
+        for (int c = 0; c < Alphabet::end_index; ++c) {
+            if (!buckets[c].empty()) order.push_back(c);
+        }
+        std::stable_sort(order.begin(), order.end(),
+                         [&](int x, int y) { return buckets[x].size() > buckets[y].size(); });
 
+        threads = std::min<unsigned>(threads, std::max<size_t>(order.size(), 1));
+        std::vector<LocalSink> sinks;
+        sinks.reserve(threads);
+        for (unsigned i = 0; i < threads; ++i) sinks.emplace_back(store_, strings_);
+        std::atomic<size_t> taken{0};
+        auto work = [&](LocalSink& sink) {
+            for (size_t i; (i = taken.fetch_add(1, std::memory_order_relaxed)) < order.size();) {
+                const auto& bucket = buckets[order[i]];
+                build_run(sink, trie_detail::deref_iterator(bucket.begin()),
+                          trie_detail::deref_iterator(bucket.end()));
+            }
+        };
+        std::vector<std::thread> pool;
+        for (unsigned i = 1; i < threads; ++i) pool.emplace_back(work, std::ref(sinks[i]));
+        work(sinks[0]);
+        for (auto& th : pool) th.join();
+
+        for (auto& sink : sinks) {
+            node_count_ += sink.nodes;
+            child_bytes_ += sink.child_bytes;
+        }
+        recompute_best(root_);
+        rebuild_prefix_cache();
     }
 
     /**
@@ -114,9 +466,55 @@ public:
      */
     Node* descend(Node* v, char c) const {
         if (!v) return nullptr;
-        int idx = (c == '$') ? end_index() : char_to_index(c);
+        int idx = char_to_index(c);
         if (idx < 0) return nullptr;
-        return v->next[idx];
+        return store_.get(v->next.get(idx));
+    }
+
+    /**
+     * @brief Desciende varias palabras a la vez, intercalando prefetch.
+     * @param first, last Palabras (convertibles a std::string_view).
+     * @param paths Salida: paths[i][j] es el nodo tras el carácter j de la
+     * palabra i, igual que aplicar descend() desde la raíz; si un descenso da
+     * nullptr se guarda y la ruta termina ahí.
+     * @details Avanza las palabras por turnos, un carácter cada vez. Al
+     * obtener el siguiente nodo de una palabra pide su línea de caché (y la
+     * del hijo que buscará después) y pasa a la siguiente palabra, de modo que
+     * los fallos de caché de todo el grupo se solapan en vez de esperarse uno
+     * a uno. Solo lee el árbol: las rutas son válidas mientras no se inserte.
+     */
+    template <typename It>
+    void descend_batch(It first, It last, std::vector<std::vector<Node*>>& paths) const {
+        struct Session {
+            std::string_view word;
+            size_t pos;
+            Node* v;
+        };
+        std::vector<Session> active;
+        size_t n = 0;
+        for (It it = first; it != last; ++it, ++n) active.push_back({std::string_view(*it), 0, root()});
+        paths.resize(n);
+        for (size_t i = 0; i < n; ++i) paths[i].clear();
+
+        std::vector<size_t> ids(n);
+        for (size_t i = 0; i < n; ++i) ids[i] = i;
+        while (!ids.empty()) {
+            size_t kept = 0;
+            for (size_t k = 0; k < ids.size(); ++k) {
+                size_t i = ids[k];
+                Session& s = active[i];
+                if (s.pos == s.word.size()) continue;
+                Node* u = descend(s.v, s.word[s.pos++]);
+                paths[i].push_back(u);
+                if (!u || s.pos == s.word.size()) continue;
+                __builtin_prefetch(u);
+                int idx = char_to_index(s.word[s.pos]);
+                if (idx >= 0) u->next.prefetch(idx);
+                s.v = u;
+                ids[kept++] = i;
+            }
+            ids.resize(kept);
+        }
     }
 
     /**
@@ -126,26 +524,245 @@ public:
      */
     Node* autocomplete(Node* v) const {
         if (!v) return nullptr;
-        return v->best_terminal;
+        return store_.get(v->load_best().terminal);
+    }
+
+    /**
+     * @brief Como autocomplete, pero retorna también la prioridad del terminal
+     * sugerido leída junto con él (en modo ThreadSafe, de una sola vez).
+     * @param v Nodo desde el cual se busca el autocompletado.
+     * @return Par (terminal o nullptr, prioridad).
+     */
+    std::pair<Node*, Counter> autocomplete_with_priority(Node* v) const {
+        if (!v) return {nullptr, Counter{}};
+        auto b = v->load_best();
+        return {store_.get(b.terminal), b.priority};
+    }
+
+    /**
+     * @brief Retorna hasta k terminales del subárbol de v, de mayor a menor prioridad.
+     * @param v Nodo desde el cual se busca el autocompletado.
+     * @param k Cantidad pedida; se acota por el K de la opción TopK<K>.
+     * @return Terminales sugeridos; el primero coincide con autocomplete(v).
+     * @details Lee la lista precalculada del nodo: O(k).
+     */
+    std::vector<Node*> autocomplete_topk(Node* v, size_t k) const {
+        static_assert(topk > 0, "autocomplete_topk requiere la opción TopK<K>");
+        std::vector<Node*> out;
+        if (!v) return out;
+        size_t n = std::min<size_t>(k, v->top.size);
+        out.reserve(n);
+        for (size_t i = 0; i < n; ++i) out.push_back(store_.get(v->top.terminal[i]));
+        return out;
     }
 
     /**
      * @brief Actualiza la prioridad de un nodo terminal y propaga la actualización hacia la raíz.
      * @param terminal Nodo terminal cuya prioridad se actualiza.
      * @details En la política de frecuencia, incrementa el contador;
-     * en la de recencia, asigna un timestamp creciente.
+     * en la de recencia, asigna un timestamp creciente. Con políticas
+     * monótonas la propagación se detiene en el primer ancestro sin cambios;
+     * con TopK<K>, en el primer ancestro cuya lista no cambia.
+     * @return Cantidad de nodos visitados durante la propagación.
+     */
+    size_t update_priority(Node* terminal) {
+        assert(terminal && terminal->is_terminal);
+        return commit(terminal_link(terminal));
+    }
+
+    /**
+     * @brief Igual que update_priority, pero con un contador de accesos externo.
+     * @param terminal Nodo terminal cuya prioridad se actualiza.
+     * @param access_counter Contador que recibe la política en lugar del propio
+     * del Trie; permite que varios Tries (p.ej. shards) compartan un mismo orden
+     * temporal. Como el reloj es del llamador, aquí no se renormaliza la época.
+     * @return Cantidad de nodos visitados durante la propagación.
      */
-    void update_priority(Node* terminal) {
+    size_t update_priority(Node* terminal, Counter& access_counter) {
         assert(terminal && terminal->is_terminal);
-        PriorityPolicy::touch(terminal->priority, global_access_counter_);
-        bubble_up(terminal);
+        std::lock_guard<Lock> guard(write_mutex_);
+        PriorityPolicy::touch(terminal->priority, access_counter);
+        return settle(terminal_link(terminal));
+    }
+
+    /**
+     * @brief Recalcula los best_* pendientes (modo DeferredPropagation).
+     * @return Cantidad de nodos visitados.
+     * @details Cada terminal anotado se propaga una sola vez aunque se haya
+     * usado muchas veces. Con políticas monótonas (y sin TopK) se usa la
+     * propagación incremental que se detiene en el primer ancestro que no
+     * cambia; si no, cada terminal y cada uno de sus ancestros se recalcula
+     * una vez, de los más profundos a los más superficiales.
+     */
+    size_t flush() {
+        std::lock_guard<Lock> guard(write_mutex_);
+        return flush_dirty();
+    }
+
+    // Actualizaciones registradas desde el último flush (0 sin DeferredPropagation).
+    size_t pending_updates() const { return pending_; }
+
+    /**
+     * @brief Fija prioridades guardadas (un checkpoint o un log) y recalcula
+     * best_* una sola vez por nodo afectado.
+     * @param first, last Pares (Node* terminal, prioridad); si un terminal se
+     * repite queda la última prioridad.
+     * @param access_counter Nuevo valor del contador global de accesos.
+     * @return Cantidad de nodos recalculados.
+     * @details Las prioridades se escriben sin propagar y los terminales se
+     * anotan como en DeferredPropagation; al final se recalculan los
+     * anotados y sus ancestros por profundidad, así que n registros sobre un
+     * mismo camino no cuestan n propagaciones. Las prioridades pueden subir
+     * o bajar.
+     */
+    template <typename It>
+    size_t restore_priorities(It first, It last, Counter access_counter) {
+        std::lock_guard<Lock> guard(write_mutex_);
+        if constexpr (Propagation::deferred) flush_dirty();
+        for (; first != last; ++first) {
+            Node* n = first->first;
+            assert(n && n->is_terminal);
+            n->priority = first->second;
+            if (!n->dirty) {
+                n->dirty = true;
+                dirty_.push_back(terminal_link(n));
+            }
+        }
+        global_access_counter_ = access_counter;
+        return recompute_dirty();
     }
 
+    /**
+     * @brief Llama a f(Node*) con cada terminal, en preorden (hijos por índice).
+     */
+    template <typename F>
+    void for_each_terminal(F&& f) const {
+        std::vector<Link> stack{root_};
+        while (!stack.empty()) {
+            Node* v = store_.get(stack.back());
+            stack.pop_back();
+            if (v->is_terminal) f(v);
+            for (int c = end_index(); c >= 0; --c) {
+                if (Link u = v->next.get(c)) stack.push_back(u);
+            }
+        }
+    }
+
+    /**
+     * @class Cursor
+     * @brief Sesión de tecleo sobre el trie: recuerda el camino desde la raíz.
+     *
+     * Guarda un enlace por carácter aceptado (4 bytes con ArenaStorage), así
+     * que borrar un carácter es O(1) y registrar el uso de la palabra no
+     * vuelve a descender desde la raíz. Los caracteres que salen del árbol
+     * solo se cuentan, para que los borrados vuelvan al último nodo válido.
+     * En modo ThreadSafe varias sesiones pueden leer en paralelo; accept()
+     * toma el mutex de escritura como update_priority.
+     */
+    class Cursor {
+    public:
+        explicit Cursor(Trie& trie) : trie_(&trie), path_{trie.root_} {}
+
+        /**
+         * @brief Agrega un carácter al texto de la sesión.
+         * @return false si el texto ya no es prefijo de ninguna palabra.
+         */
+        bool push_char(char c) {
+            if (off_tree_ == 0) {
+                int idx = char_to_index(c);
+                Link u = idx >= 0 && idx != end_index() ? trie_->store_.get(path_.back())->next.get(idx) : Link{};
+                if (u) {
+                    path_.push_back(u);
+                    return true;
+                }
+            }
+            ++off_tree_;
+            return false;
+        }
+
+        // Borra el último carácter (no hace nada si el texto está vacío).
+        void pop_char() {
+            if (off_tree_ > 0) {
+                --off_tree_;
+            } else if (path_.size() > 1) {
+                path_.pop_back();
+            }
+        }
+
+        // Vuelve a la raíz, conservando la memoria del camino.
+        void reset() {
+            path_.resize(1);
+            off_tree_ = 0;
+        }
+
+        // Caracteres tecleados (incluye los que salieron del árbol).
+        size_t depth() const { return path_.size() - 1 + off_tree_; }
+
+        // Nodo del texto actual, o nullptr si salió del árbol.
+        Node* node() const { return off_tree_ ? nullptr : trie_->store_.get(path_.back()); }
+
+        // Mejor terminal para el texto actual (como autocomplete(node())).
+        Node* suggestion() const { return trie_->autocomplete(node()); }
+
+        /**
+         * @brief Registra un uso de la palabra tecleada.
+         * @return Su terminal, o nullptr si el texto no es una palabra del trie.
+         */
+        Node* accept() {
+            Node* v = node();
+            Link t = v ? v->next.get(end_index()) : Link{};
+            if (!t) return nullptr;
+            trie_->commit(t);
+            return trie_->store_.get(t);
+        }
+
+        /**
+         * @brief Registra un uso de la sugerencia actual (el usuario la eligió).
+         * @return El terminal sugerido, o nullptr si no había sugerencia.
+         */
+        Node* accept_suggestion() {
+            Node* t = suggestion();
+            if (t) trie_->commit(trie_->terminal_link(t));
+            return t;
+        }
+
+    private:
+        Trie* trie_;
+        std::vector<Link> path_;    // path_[d]: nodo tras d caracteres; path_[0] es la raíz
+        size_t off_tree_ = 0;       // caracteres tecleados fuera del árbol
+    };
+
+    // Nueva sesión de tecleo sobre este trie.
+    Cursor cursor() { return Cursor(*this); }
+
+    /**
+     * @brief Palabra guardada en un terminal.
+     * @details La vista apunta a la arena de strings y es válida mientras
+     * viva el Trie.
+     */
+    std::string_view word(const Node* t) const { return strings_.get(t->str); }
+
+    /**
+     * @brief Palabra guardada con el handle h (el `str` de un terminal).
+     * @details Se puede leer desde otro hilo mientras se inserta (la arena no
+     * mueve sus bloques), pero no durante compact(), que cambia los handles.
+     */
+    std::string_view word_at(StringArena::Handle h) const { return strings_.get(h); }
+
+    // Bytes reservados por la arena de strings.
+    size_t string_bytes() const { return strings_.bytes_used(); }
+
+    // Valor actual del contador global de accesos (lo guarda save_snapshot).
+    Counter access_counter() const { return global_access_counter_; }
+
+    // Veces que se adelantó la época de la política (0 si no tiene).
+    size_t renormalizations() const { return renormalizations_; }
+
     /**
      * @brief Retorna el nodo raíz del Trie.
      * @return Puntero al nodo raíz.
      */
-    Node* root() const { return root_; }
+    Node* root() const { return store_.get(root_); }
 
     /**
      * @brief Retorna el número total de nodos actualmente en el Trie.
@@ -153,72 +770,641 @@ public:
      */
     size_t node_count() const { return node_count_; }
 
+    // Nodos eliminados que esperan ser reutilizados (se cuentan en bytes_used).
+    size_t free_nodes() const { return store_.free_count(); }
+
+    /**
+     * @brief Retorna los bytes que ocupa el almacenamiento de nodos.
+     * @return Bytes usados por los nodos (o reservados por la arena) más los
+     * arreglos de hijos que viven fuera del nodo.
+     */
+    size_t bytes_used() const { return store_.bytes_used() + child_bytes_; }
+
+    /**
+     * @brief Retorna los bytes que ocupan las listas top-k (ya incluidos en bytes_used).
+     */
+    size_t topk_bytes() const {
+        if constexpr (topk > 0) {
+            return node_count_ * sizeof(TopKList<Link, Counter, topk>);
+        } else {
+            return 0;
+        }
+    }
+
     // Utilidad: desciende por un string prefijo (sin forzar '$')
     Node* descend_prefix(const std::string& pref) const {
-        Node* v = root_;
+        Node* v = root();
+        size_t depth = 0;
         for (char ch : pref) {
             v = descend(v, ch);
-            if (!v) return nullptr;
+            if (!v) break;
+            ++depth;
         }
+        count([&](TrieStats& s) {
+            ++s.prefix_descents;
+            s.prefix_nodes += depth;
+        });
         return v;
     }
 
+    // Resultado de lookup_prefix: nodo del prefijo y su mejor terminal.
+    struct PrefixMatch {
+        Node* node = nullptr;
+        Node* best = nullptr;
+        bool from_table = false;        // respondida entera por la tabla, sin tocar nodos
+    };
+
+    /**
+     * @brief Nodo de un prefijo y su autocompletado en una sola consulta.
+     * @param pref Prefijo tecleado; como en descend, un carácter fuera del
+     * alfabeto deja la consulta sin nodo.
+     * @return {descend_prefix(pref), autocomplete(descend_prefix(pref))} y
+     * si la respuesta salió entera de la tabla.
+     * @details Con PrefixCache<D> los prefijos de hasta D letras se responden
+     * con una lectura de la tabla, sin tocar nodos; los más largos descienden
+     * desde el nodo de sus primeras D letras. Con DeferredPropagation la
+     * tabla refleja lo propagado en el último flush, igual que los nodos.
+     */
+    PrefixMatch lookup_prefix(std::string_view pref) const {
+        Node* v = root();
+        size_t from = 0;
+        if constexpr (prefix_cache_depth > 0) {
+            size_t n = std::min(pref.size(), prefix_cache_depth), s;
+            if (PrefixCacheTable::slot(pref.substr(0, n), s)) {
+                const auto& e = prefix_cache_[s];
+                if (n == pref.size()) return {store_.get(e.node), store_.get(e.best), true};
+                v = store_.get(e.node);
+                from = n;
+            }
+        }
+        for (size_t i = from; i < pref.size() && v; ++i) v = descend(v, pref[i]);
+        return {v, autocomplete(v), false};
+    }
+
+    // Bytes de la tabla de prefijos (0 sin PrefixCache).
+    size_t prefix_cache_bytes() const {
+        if constexpr (prefix_cache_depth > 0) {
+            return PrefixCacheTable::bytes();
+        } else {
+            return 0;
+        }
+    }
+
+    /**
+     * @brief Contadores del camino caliente (requiere la opción CollectStats).
+     * @details Nodos por descend_prefix, nodos por propagación (insert,
+     * update_priority, flush y erase), casilleros de hijos leídos por
+     * recompute_best y cambios de best_terminal. Ver TrieStats.
+     */
+    const TrieStats& stats() const {
+        static_assert(collect_stats, "stats() requiere la opción CollectStats");
+        return stats_;
+    }
+
+    void reset_stats() {
+        static_assert(collect_stats, "reset_stats() requiere la opción CollectStats");
+        stats_ = TrieStats{};
+    }
+
 private:
-    Node* root_;
+    using Lock = trie_detail::write_lock_t<Sync>;
+
+    struct CloneTag {};
+
+    Trie(CloneTag, Trie& source)
+        : root_(), node_count_(source.node_count_), global_access_counter_(source.global_access_counter_) {
+        std::lock_guard<Lock> guard(source.write_mutex_);
+        if constexpr (Propagation::deferred) source.flush_dirty();
+        renormalizations_ = source.renormalizations_;
+        root_ = source.copy_nodes(store_, strings_, child_bytes_, true);
+        rebuild_prefix_cache();
+    }
+
+    Store store_;
+    Link root_;
     size_t node_count_;
+    size_t child_bytes_ = 0;
     Counter global_access_counter_;
-    // Guardamos strings en un contenedor 
-    std::deque<std::string> strings_;
+    Lock write_mutex_;              // serializa escritores en modo ThreadSafe
+    // Palabras de los terminales, cada una guardada una vez por terminal
+    StringArena strings_;
+    std::vector<Link> dirty_;       // terminales con best_* pendiente (DeferredPropagation)
+    size_t pending_ = 0;            // actualizaciones desde el último flush
+    size_t renormalizations_ = 0;
+    mutable trie_detail::stats_storage_t<Instrumentation> stats_;   // vacío sin CollectStats
+    using PrefixCacheTable = trie_detail::prefix_table_t<Link, Alphabet, prefix_cache_depth>;
+    PrefixCacheTable prefix_cache_;                                 // vacío sin PrefixCache
+
+    // Punto de conteo: con NoStats no genera código.
+    template <typename F>
+    void count(F&& f) const {
+        if constexpr (collect_stats) f(stats_);
+    }
 
-    static int end_index() { return 26; }
+    static int end_index() { return Alphabet::end_index; }
 
-    static int char_to_index(char c) {
-        if (c == '$') return end_index();
-        if (std::isalpha(static_cast<unsigned char>(c))) {
-            char x = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
-            return (x - 'a');
+    /**
+     * @brief Copia los nodos vivos en preorden (hijos en orden de índice) a
+     * `fresh` y sus palabras a `words`.
+     * @return Raíz de la copia; `child_bytes` recibe los bytes de sus hijos.
+     * @details Al copiar un nodo, el viejo guarda su dirección nueva en
+     * `parent` y los enlaces a terminales (best_*, top) se traducen al final.
+     * Con keep_source se restaura `parent` en el árbol de origen (clone);
+     * compact lo descarta entero.
+     */
+    Link copy_nodes(Store& fresh, StringArena& words, size_t& child_bytes, bool keep_source) {
+        std::vector<Link> order;            // nodos nuevos en preorden
+        std::vector<std::pair<Node*, Link>> sources;    // nodo viejo y su padre viejo
+        order.reserve(node_count_);
+        if (keep_source) sources.reserve(node_count_);
+        struct Pending {
+            Link old;
+            Link parent;                    // padre nuevo
+            int idx;
+        };
+        std::vector<Pending> stack{{root_, Link{}, -1}};
+        while (!stack.empty()) {
+            Pending p = stack.back();
+            stack.pop_back();
+            Node* o = store_.get(p.old);
+            Link nl = fresh.create();
+            Node* n = fresh.get(nl);
+            n->is_terminal = o->is_terminal;
+            n->priority = o->priority;
+            if (o->is_terminal) n->str = words.add(strings_.get(o->str));
+            auto b = o->load_best();
+            n->store_best(b.terminal, b.priority);      // enlace viejo, se traduce abajo
+            if constexpr (topk > 0) n->top = o->top;
+            n->parent = p.parent;
+            if (p.parent) child_bytes += fresh.get(p.parent)->next.set(p.idx, nl);
+            for (int c = end_index(); c >= 0; --c) {
+                if (Link u = o->next.get(c)) stack.push_back({u, nl, c});
+            }
+            if (keep_source) sources.emplace_back(o, o->parent);
+            o->parent = nl;
+            order.push_back(nl);
+        }
+        for (Link nl : order) {
+            Node* n = fresh.get(nl);
+            auto b = n->load_best();
+            if (b.terminal) n->store_best(store_.get(b.terminal)->parent, b.priority);
+            if constexpr (topk > 0) {
+                for (size_t i = 0; i < n->top.size; ++i) n->top.terminal[i] = store_.get(n->top.terminal[i])->parent;
+            }
+        }
+        for (auto& [o, parent] : sources) o->parent = parent;
+        return order.front();
+    }
+
+    // Reescribe las entradas de la tabla de prefijos en el camino de w (las
+    // de sus primeras D letras): tras insertar, borrar o propagar w son las
+    // únicas que pueden haber cambiado. Si un nodo ya no existe, sus
+    // entradas y las de más abajo quedan vacías.
+    void refresh_prefix_cache(std::string_view w) {
+        if constexpr (prefix_cache_depth > 0) {
+            typename PrefixCacheTable::Key key;
+            Link v = root_;
+            prefix_cache_[key.slot()] = {v, store_.get(v)->load_best().terminal};
+            size_t depth = 0;
+            for (char ch : w) {
+                int idx = char_to_index(ch);
+                if (idx < 0) continue;
+                if (idx == end_index() || depth == prefix_cache_depth) break;
+                key.push(idx);
+                ++depth;
+                v = v ? store_.get(v)->next.get(idx) : Link{};
+                prefix_cache_[key.slot()] = {v, v ? store_.get(v)->load_best().terminal : Link{}};
+            }
         }
-        return -1;
+    }
+
+    // Llena la tabla de prefijos desde cero (construcción en bloque, compact).
+    void rebuild_prefix_cache() {
+        if constexpr (prefix_cache_depth > 0) {
+            using Key = typename PrefixCacheTable::Key;
+            prefix_cache_.clear();
+            struct Pending {
+                Link v;
+                Key key;
+                size_t depth;
+            };
+            std::vector<Pending> stack{{root_, Key{}, 0}};
+            while (!stack.empty()) {
+                Pending p = stack.back();
+                stack.pop_back();
+                Node* n = store_.get(p.v);
+                prefix_cache_[p.key.slot()] = {p.v, n->load_best().terminal};
+                if (p.depth == prefix_cache_depth) continue;
+                for (int c = 0; c < end_index(); ++c) {
+                    if (Link u = n->next.get(c)) {
+                        Key k = p.key;
+                        k.push(c);
+                        stack.push_back({u, k, p.depth + 1});
+                    }
+                }
+            }
+        }
+    }
+
+    // Destino de lo que crea una inserción: nodos, contadores y copias de
+    // las palabras. SerialSink escribe directo en el trie; build_parallel le
+    // da a cada hilo un LocalSink y suma sus contadores al terminar.
+    struct SerialSink {
+        Trie& trie;
+        Link create() { return trie.store_.create(); }
+        void created(size_t child_bytes) {
+            ++trie.node_count_;
+            trie.child_bytes_ += child_bytes;
+        }
+        StringArena::Handle keep(const std::string& w) { return trie.strings_.add(w); }
+    };
+
+    struct LocalSink {
+        typename Store::Local alloc;
+        size_t nodes = 0;
+        size_t child_bytes = 0;
+        StringArena::Local strings;
+
+        LocalSink(Store& store, StringArena& arena) : alloc(store.local()), strings(arena.local()) {}
+        Link create() { return alloc.create(); }
+        void created(size_t extra) {
+            ++nodes;
+            child_bytes += extra;
+        }
+        StringArena::Handle keep(const std::string& w) { return strings.add(w); }
+    };
+
+    // Retorna el hijo `idx` de `v`, creándolo si no existe. `init` completa el
+    // nodo nuevo antes de enlazarlo, para que un lector concurrente no lo vea a medias.
+    template <typename Sink, typename Init>
+    Link child_or_create(Sink& sink, Link v, int idx, Init&& init) {
+        Node* n = store_.get(v);
+        Link u = n->next.get(idx);
+        if (!u) {
+            u = sink.create();
+            Node* c = store_.get(u);
+            c->parent = v;
+            init(c);
+            sink.created(n->next.set(idx, u));
+        }
+        return u;
+    }
+
+    template <typename Sink>
+    Link child_or_create(Sink& sink, Link v, int idx) {
+        return child_or_create(sink, v, idx, [](Node*) {});
+    }
+
+    // Crea (o reutiliza) el terminal '$' bajo v y le asocia la palabra w.
+    // No propaga: el llamador decide cómo actualizar best_*.
+    template <typename Sink>
+    Link add_terminal(Sink& sink, Link v, const std::string& w) {
+        // Marca fin de palabra con '$'; el terminal se publica ya inicializado,
+        // con su palabra
+        Link t = child_or_create(sink, v, end_index(), [&](Node* n) {
+            n->is_terminal = true;
+            n->str = sink.keep(w);
+        });
+        Node* term = store_.get(t);
+
+        // Reinsertar la palabra (aunque cambien las mayúsculas) conserva la
+        // primera grafía: str no se reescribe mientras un lector ThreadSafe
+        // puede estar leyéndolo con word()
+
+        // Inicializamos prioridad en 0
+        if (term->priority == 0) term->priority = 0;
+        return t;
     }
 
+    /**
+     * @brief Núcleo de build_from_sorted: inserta [first, last) desde la raíz.
+     * @details Calcula best_* de cada nodo que deja el camino y al final de
+     * los que quedan en él, salvo la raíz (la recalcula el llamador). Así
+     * build_parallel puede correrlo en varios hilos sobre letras distintas.
+     */
+    template <typename Sink, typename It>
+    void build_run(Sink& sink, It first, It last) {
+        std::vector<Link> path{root_};      // path[d]: nodo a profundidad d
+        std::vector<int> prev, cur;         // índices de la palabra anterior y actual
+        for (; first != last; ++first) {
+            const std::string& w = *first;
+            cur.clear();
+            for (char ch : w) {
+                int idx = char_to_index(ch);
+                if (idx >= 0) cur.push_back(idx);
+            }
+            size_t lcp = 0;
+            while (lcp < prev.size() && lcp < cur.size() && prev[lcp] == cur[lcp]) ++lcp;
+
+            // Los nodos bajo el prefijo común quedaron completos
+            while (path.size() > lcp + 1) {
+                recompute_best(path.back());
+                path.pop_back();
+            }
+            for (size_t d = lcp; d < cur.size(); ++d) {
+                path.push_back(child_or_create(sink, path.back(), cur[d]));
+            }
+            recompute_best(add_terminal(sink, path.back(), w));
+            prev.swap(cur);
+        }
+        while (path.size() > 1) {
+            recompute_best(path.back());
+            path.pop_back();
+        }
+    }
+
+    // Enlace de un terminal: es siempre el hijo '$' de su padre.
+    Link terminal_link(Node* terminal) const {
+        if constexpr (std::is_pointer_v<Link>) {
+            return terminal;
+        } else {
+            return store_.get(terminal->parent)->next.get(end_index());
+        }
+    }
+
+    // Índice de hijo del carácter c según el alfabeto ('$' da end_index(); -1 si se descarta).
+    static int char_to_index(char c) { return Alphabet::index(c); }
+
     /**
      * @brief Recalcula el mejor nodo terminal de un subárbol.
      * @param v Nodo desde el cual se propaga la actualización.
      * @details Se usa tras cada inserción o cambio de prioridad.
      */
-    static void recompute_best(Node* v) {
+    void recompute_best(Link vl) {
+        if constexpr (topk > 0) {
+            recompute_topk(vl);
+            return;
+        }
+        Node* v = store_.get(vl);
         // Mejor candidato: él mismo si terminal
-        Node* best = (v->is_terminal ? v : nullptr);
+        Link best = (v->is_terminal ? vl : Link{});
         Counter bestp = (v->is_terminal ? v->priority : 0);
 
         // O alguno de sus hijos
-        for (Node* u : v->next) {
-            if (!u) continue;
-            if (u->best_terminal && u->best_priority > bestp) {
-                best = u->best_terminal;
-                bestp = u->best_priority;
+        v->next.for_each([&](Link ul) {
+            auto ub = store_.get(ul)->load_best();
+            if (ub.terminal && ub.priority > bestp) {
+                best = ub.terminal;
+                bestp = ub.priority;
             }
+        });
+        count([&](TrieStats& s) {
+            ++s.recomputes;
+            s.slots_scanned += v->next.scan_width();
+            s.best_changes += v->load_best().terminal != best;
+        });
+        v->store_best(best, bestp);
+    }
+
+    // Registra un uso del terminal t (update_priority sin buscar el enlace).
+    size_t commit(Link t) {
+        std::lock_guard<Lock> guard(write_mutex_);
+        PriorityPolicy::touch(store_.get(t)->priority, global_access_counter_);
+        size_t visited = settle(t);
+        if constexpr (trie_detail::renormalizes<PriorityPolicy>::value) {
+            if (PriorityPolicy::epoch_full(global_access_counter_)) visited += renormalize();
         }
-        v->best_terminal = best;
-        v->best_priority = bestp;
+        return visited;
+    }
+
+    /**
+     * @brief Adelanta la época de la política y reexpresa las prioridades.
+     * @return Cantidad de nodos visitados.
+     * @details Policy::rebase resta la misma constante a todas las claves (las
+     * que quedan bajo ella pasan a 1), así que no cambia cuál es el mejor
+     * terminal de cada subárbol: basta reescribir prioridades y best_* en su
+     * lugar. Un subárbol cuyo best_priority es 0 o 1 no cambia y no se
+     * recorre, de modo que solo se visita la parte del árbol usada desde que
+     * sus claves tocaron el piso. Corre una vez cada Policy::epoch_ticks usos.
+     */
+    size_t renormalize() {
+        if constexpr (Propagation::deferred) flush_dirty();
+        PriorityPolicy::advance(global_access_counter_);
+        size_t visited = 0;
+        std::vector<Link> stack{root_};
+        while (!stack.empty()) {
+            Node* v = store_.get(stack.back());
+            stack.pop_back();
+            ++visited;
+            auto b = v->load_best();
+            if (b.priority <= 1) continue;
+            v->store_best(b.terminal, PriorityPolicy::rebase(b.priority));
+            if (v->is_terminal) v->priority = PriorityPolicy::rebase(v->priority);
+            if constexpr (topk > 0) {
+                for (size_t i = 0; i < v->top.size; ++i) v->top.priority[i] = PriorityPolicy::rebase(v->top.priority[i]);
+            }
+            v->next.for_each([&](Link u) { stack.push_back(u); });
+        }
+        ++renormalizations_;
+        return visited;
+    }
+
+    // Tras subir la prioridad de t: propaga ahora o lo deja pendiente.
+    size_t settle(Link t) {
+        if constexpr (Propagation::deferred) {
+            Node* n = store_.get(t);
+            if (!n->dirty) {
+                n->dirty = true;
+                dirty_.push_back(t);
+            }
+            ++pending_;
+            if (Propagation::flush_every && pending_ >= Propagation::flush_every) return flush_dirty();
+            return 0;
+        } else {
+            return propagate(t);
+        }
+    }
+
+    // Recalcula los terminales anotados y sus ancestros. Con políticas
+    // monótonas basta una propagación incremental por terminal distinto (cada
+    // una parte de un estado consistente con las prioridades ya propagadas);
+    // si no, se recalcula cada nodo afectado una vez, por profundidad.
+    size_t flush_dirty() {
+        if constexpr (topk == 0 && trie_detail::is_monotonic<PriorityPolicy>::value) {
+            size_t visited = 0;
+            for (Link t : dirty_) {
+                store_.get(t)->dirty = false;
+                size_t n = propagate_increase(t);
+                count([&](TrieStats& s) { s.note_propagation(n); });
+                refresh_prefix_cache(word(store_.get(t)));
+                visited += n;
+            }
+            dirty_.clear();
+            pending_ = 0;
+            return visited;
+        }
+        return recompute_dirty();
+    }
+
+    // Recalcula cada terminal anotado y cada uno de sus ancestros una vez, de
+    // los más profundos a los más superficiales. No supone nada sobre cómo
+    // cambiaron las prioridades (sirve también si alguna bajó).
+    size_t recompute_dirty() {
+        std::vector<std::vector<Link>> by_depth;
+        for (Link t : dirty_) {
+            size_t depth = 0;
+            for (Link u = store_.get(t)->parent; u; u = store_.get(u)->parent) ++depth;
+            if (by_depth.size() <= depth) by_depth.resize(depth + 1);
+            by_depth[depth].push_back(t);
+
+            // Sube hasta el primer ancestro ya anotado por otro terminal
+            for (Link u = store_.get(t)->parent; u && !store_.get(u)->dirty; u = store_.get(u)->parent) {
+                store_.get(u)->dirty = true;
+                by_depth[--depth].push_back(u);
+            }
+        }
+        size_t recomputed = 0;
+        for (size_t d = by_depth.size(); d-- > 0;) {
+            for (Link u : by_depth[d]) {
+                recompute_best(u);
+                store_.get(u)->dirty = false;
+                ++recomputed;
+            }
+        }
+        for (Link t : dirty_) refresh_prefix_cache(word(store_.get(t)));
+        dirty_.clear();
+        pending_ = 0;
+        count([&](TrieStats& s) { s.note_propagation(recomputed); });
+        return recomputed;
+    }
+
+    // Propaga el cambio de prioridad del terminal t según la configuración.
+    size_t propagate(Link t) {
+        size_t visited;
+        if constexpr (topk > 0) {
+            visited = refresh_until_stable(t);
+        } else if constexpr (trie_detail::is_monotonic<PriorityPolicy>::value) {
+            visited = propagate_increase(t);
+        } else {
+            visited = bubble_up(t);
+        }
+        count([&](TrieStats& s) { s.note_propagation(visited); });
+        refresh_prefix_cache(word(store_.get(t)));
+        return visited;
+    }
+
+    // Tras quitar un hijo de `from`: lo recalcula y sube mientras el mejor
+    // (o la lista top-k) de cada ancestro cambie.
+    size_t repair_from(Link from) {
+        if constexpr (topk > 0) {
+            size_t visited = refresh_until_stable(from);
+            count([&](TrieStats& s) { s.note_propagation(visited); });
+            return visited;
+        } else {
+            size_t visited = 0;
+            for (Link vl = from; vl; vl = store_.get(vl)->parent) {
+                Node* v = store_.get(vl);
+                auto before = v->load_best();
+                recompute_best(vl);
+                ++visited;
+                auto after = v->load_best();
+                if (vl != from && after.terminal == before.terminal && after.priority == before.priority) break;
+            }
+            count([&](TrieStats& s) { s.note_propagation(visited); });
+            return visited;
+        }
+    }
+
+    /**
+     * @brief Recalcula la lista top-k de v mezclando las de sus hijos.
+     * @details Los hijos se recorren en orden de índice y sus listas ya están
+     * ordenadas, así que cada hijo se corta en cuanto un candidato no entra.
+     * Como en recompute_best, en nodos internos solo cuentan prioridades > 0;
+     * best_* queda igual al primer candidato.
+     */
+    void recompute_topk(Link vl) {
+        Node* v = store_.get(vl);
+        TopKList<Link, Counter, topk> merged;
+        if (v->is_terminal) merged.offer(vl, v->priority);
+        v->next.for_each([&](Link ul) {
+            const Node* u = store_.get(ul);
+            for (size_t i = 0; i < u->top.size; ++i) {
+                if (u->top.priority[i] == 0) break;
+                if (!merged.offer(u->top.terminal[i], u->top.priority[i])) break;
+            }
+        });
+        v->top = merged;
+        Link best = merged.size ? merged.terminal[0] : Link{};
+        count([&](TrieStats& s) {
+            ++s.recomputes;
+            s.slots_scanned += v->next.scan_width();
+            s.best_changes += v->load_best().terminal != best;
+        });
+        v->store_best(best, merged.size ? merged.priority[0] : Counter{});
+    }
+
+    /**
+     * @brief Propagación con listas top-k: recalcula hacia la raíz y se
+     * detiene en el primer ancestro cuya lista no cambió.
+     * @return Cantidad de nodos visitados.
+     */
+    size_t refresh_until_stable(Link from) {
+        size_t visited = 0;
+        Link vl = from;
+        while (vl) {
+            Node* v = store_.get(vl);
+            ++visited;
+            TopKList<Link, Counter, topk> before = v->top;
+            recompute_topk(vl);
+            if (vl != from && v->top == before) break;
+            vl = v->parent;
+        }
+        return visited;
     }
 
     /**
      * @brief Propaga hacia arriba la actualización de prioridades.
      * @param from Nodo desde el cual se comienza a actualizar.
+     * @return Cantidad de nodos recalculados.
      */
-    static void bubble_up(Node* from) {
-        Node* v = from;
+    size_t bubble_up(Link from) {
+        size_t visited = 0;
+        Link v = from;
         while (v) {
             recompute_best(v);
-            v = v->parent;
+            ++visited;
+            v = store_.get(v)->parent;
         }
+        return visited;
     }
 
+    /**
+     * @brief Propagación incremental tras aumentar la prioridad de un terminal.
+     * @param t Terminal cuya prioridad acaba de subir (es hoja: su mejor es él).
+     * @return Cantidad de nodos visitados.
+     * @details Válida solo para políticas monótonas. En cada ancestro:
+     * - si su mejor ya era t, solo sube best_priority;
+     * - si t supera estrictamente al mejor, t pasa a ser el mejor;
+     * - si empatan, el desempate depende del orden de los hijos y se recalcula;
+     * - si no, nada cambia aquí ni más arriba y se detiene.
+     * Los ancestros dependen solo del par (best_terminal, best_priority) de sus
+     * hijos, por lo que parar cuando ese par no cambia es exacto.
+     */
+    size_t propagate_increase(Link t) {
+        Node* tn = store_.get(t);
+        const Counter p = tn->priority;
+        tn->store_best(t, p);
 
-    static void clear(Node* v) {
-        if (!v) return;
-        for (Node* u : v->next) clear(u);
-        delete v;
+        size_t visited = 1;
+        Link vl = tn->parent;
+        while (vl) {
+            Node* v = store_.get(vl);
+            ++visited;
+            auto b = v->load_best();
+            if (b.terminal == t) {
+                if (b.priority == p) break;
+                v->store_best(t, p);
+            } else if (p > b.priority) {
+                v->store_best(t, p);
+                count([](TrieStats& s) { ++s.best_changes; });
+            } else if (p == b.priority) {
+                recompute_best(vl);
+                if (v->load_best().terminal == b.terminal) break;
+            } else {
+                break;
+            }
+            vl = v->parent;
+        }
+        return visited;
     }
 };
@@ -0,0 +1,23 @@
+#pragma once
+#include <cstddef>
+
+// --- Momento de la propagación ---------------------------------------------
+// ImmediatePropagation (por defecto) actualiza best_* en cada update_priority.
+// DeferredPropagation<N> solo sube la prioridad del terminal y lo anota como
+// pendiente; los best_* se recalculan en Trie::flush(), que también se llama
+// sola cada N actualizaciones (N = 0: solo a mano). Entre flush y flush las
+// sugerencias pueden no reflejar los últimos usos.
+
+// Marca común para que el Trie reconozca la opción de propagación.
+struct PropagationOption {};
+
+struct ImmediatePropagation : PropagationOption {
+    static constexpr bool deferred = false;
+    static constexpr size_t flush_every = 0;
+};
+
+template <size_t N = 0>
+struct DeferredPropagation : PropagationOption {
+    static constexpr bool deferred = true;
+    static constexpr size_t flush_every = N;
+};
@@ -0,0 +1,297 @@
+#pragma once
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "trie.hpp"
+
+// --- Snapshot binario del Trie ----------------------------------------------
+// Formato (versión 1, enteros en el orden de bytes de la máquina):
+//   SnapshotHeader
+//   SnapshotNode[node_count]   en orden BFS: los hijos de un nodo son contiguos
+//   char[pool_bytes]           palabras de los terminales, sin separadores
+// Los enlaces son índices dentro del arreglo de nodos; la raíz es el 0, y como
+// nunca es hija ni terminal, el 0 sirve también de enlace nulo.
+
+constexpr uint32_t snapshot_version = 1;
+
+struct SnapshotHeader {
+    char magic[8];              // "TRIESNAP"
+    uint32_t version;
+    uint32_t node_size;         // sizeof(SnapshotNode), para detectar otro formato
+    uint64_t node_count;
+    uint64_t pool_bytes;
+    uint64_t access_counter;    // contador global de accesos al guardar
+    char policy[16];            // PriorityPolicy::name()
+};
+
+struct SnapshotNode {
+    uint32_t first_child;       // índice del primer hijo
+    uint32_t children;          // bit i: existe el hijo i (26 = '$'); bit 31: terminal
+    uint32_t parent;
+    uint32_t best_terminal;
+    uint64_t priority;
+    uint64_t best_priority;
+    uint32_t str_offset;        // palabra del terminal dentro del pool
+    uint32_t str_len;
+};
+
+static_assert(sizeof(SnapshotHeader) % 8 == 0 && sizeof(SnapshotNode) == 40,
+              "El formato del snapshot no debe depender del compilador");
+
+namespace trie_detail {
+constexpr uint32_t snapshot_terminal_bit = uint32_t(1) << 31;
+constexpr char snapshot_magic[8] = {'T', 'R', 'I', 'E', 'S', 'N', 'A', 'P'};
+} // namespace trie_detail
+
+/**
+ * @brief Guarda el trie en `path`: nodos, prioridades, best_* y palabras.
+ * @details Recorre el árbol en BFS con la API pública (descend,
+ * autocomplete_with_priority), así que sirve para cualquier combinación de
+ * opciones. Lanza std::runtime_error si no puede escribir el archivo.
+ */
+template <typename PriorityPolicy, typename... Options>
+void save_snapshot(const Trie<PriorityPolicy, Options...>& trie, const std::string& path) {
+    using T = Trie<PriorityPolicy, Options...>;
+    using Node = typename T::Node;
+    static_assert(T::sigma == LowercaseAlphabet::size, "El snapshot usa un bitmap de 32 bits: Σ = 27");
+    const auto& symbols = LowercaseAlphabet::symbols;
+
+    // Primera pasada: orden BFS e índices
+    std::vector<Node*> order{trie.root()};
+    std::unordered_map<const Node*, uint32_t> index{{trie.root(), 0}};
+    for (size_t i = 0; i < order.size(); ++i) {
+        for (char c : symbols) {
+            if (Node* u = trie.descend(order[i], c)) {
+                index.emplace(u, static_cast<uint32_t>(order.size()));
+                order.push_back(u);
+            }
+        }
+    }
+
+    // Segunda pasada: registros y pool
+    std::vector<SnapshotNode> nodes(order.size());
+    std::string pool;
+    uint32_t next_child = 1;
+    for (size_t i = 0; i < order.size(); ++i) {
+        const Node* v = order[i];
+        SnapshotNode& r = nodes[i];
+        r.first_child = next_child;
+        r.children = v->is_terminal ? trie_detail::snapshot_terminal_bit : 0;
+        for (int c = 0; c < 27; ++c) {
+            if (Node* u = trie.descend(const_cast<Node*>(v), symbols[c])) {
+                r.children |= uint32_t(1) << c;
+                nodes[index[u]].parent = static_cast<uint32_t>(i);
+                ++next_child;
+            }
+        }
+        auto [best, bestp] = trie.autocomplete_with_priority(const_cast<Node*>(v));
+        r.best_terminal = best ? index[best] : 0;
+        r.best_priority = static_cast<uint64_t>(bestp);
+        r.priority = static_cast<uint64_t>(v->priority);
+        if (v->str) {
+            std::string_view w = trie.word(v);
+            r.str_offset = static_cast<uint32_t>(pool.size());
+            r.str_len = static_cast<uint32_t>(w.size());
+            pool += w;
+        }
+    }
+
+    SnapshotHeader h{};
+    std::memcpy(h.magic, trie_detail::snapshot_magic, sizeof(h.magic));
+    h.version = snapshot_version;
+    h.node_size = sizeof(SnapshotNode);
+    h.node_count = nodes.size();
+    h.pool_bytes = pool.size();
+    h.access_counter = static_cast<uint64_t>(trie.access_counter());
+    std::strncpy(h.policy, PriorityPolicy::name(), sizeof(h.policy) - 1);
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    out.write(reinterpret_cast<const char*>(nodes.data()), nodes.size() * sizeof(SnapshotNode));
+    out.write(pool.data(), pool.size());
+    if (!out) throw std::runtime_error("save_snapshot: no se pudo escribir " + path);
+}
+
+/**
+ * @class MappedTrie
+ * @brief Trie de solo lectura servido directamente desde un snapshot mapeado
+ * con mmap, sin deserializar.
+ *
+ * Abrir el snapshot cuesta lo mismo sin importar su tamaño; las páginas se
+ * cargan a medida que las consultas las tocan. update_priority no escribe el
+ * archivo: las prioridades y best_* modificados viven en un overlay en
+ * memoria que las lecturas consultan antes que el mapeo. La propagación
+ * recalcula cada ancestro desde sus hijos y se detiene en el primero que no
+ * cambia, con el mismo desempate que Trie::recompute_best.
+ *
+ * @tparam PriorityPolicy Debe ser la misma política con que se guardó.
+ */
+template <typename PriorityPolicy>
+class MappedTrie {
+public:
+    using Counter = typename PriorityPolicy::Counter;
+    using policy_type = PriorityPolicy;
+    using Node = SnapshotNode;
+
+    /**
+     * @brief Mapea el snapshot de `path`.
+     * @details Lanza std::runtime_error si el archivo no existe, no es un
+     * snapshot, es de otra versión o fue guardado con otra política.
+     */
+    explicit MappedTrie(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("MappedTrie: no se pudo abrir " + path);
+        struct stat st {};
+        if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(SnapshotHeader)) {
+            ::close(fd);
+            throw std::runtime_error("MappedTrie: archivo demasiado corto: " + path);
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) throw std::runtime_error("MappedTrie: mmap falló para " + path);
+        base_ = static_cast<const char*>(p);
+
+        const auto* h = reinterpret_cast<const SnapshotHeader*>(base_);
+        std::string error;
+        if (std::memcmp(h->magic, trie_detail::snapshot_magic, sizeof(h->magic)) != 0) {
+            error = "no es un snapshot";
+        } else if (h->version != snapshot_version || h->node_size != sizeof(SnapshotNode)) {
+            error = "versión de snapshot no soportada";
+        } else if (std::strncmp(h->policy, PriorityPolicy::name(), sizeof(h->policy)) != 0) {
+            error = "snapshot guardado con otra política";
+        } else if (sizeof(SnapshotHeader) + h->node_count * sizeof(SnapshotNode) + h->pool_bytes > size_) {
+            error = "snapshot truncado";
+        }
+        if (!error.empty()) {
+            ::munmap(const_cast<char*>(base_), size_);
+            throw std::runtime_error("MappedTrie: " + error + ": " + path);
+        }
+        nodes_ = reinterpret_cast<const SnapshotNode*>(base_ + sizeof(SnapshotHeader));
+        node_count_ = h->node_count;
+        pool_ = reinterpret_cast<const char*>(nodes_ + node_count_);
+        global_access_counter_ = static_cast<Counter>(h->access_counter);
+    }
+
+    MappedTrie(const MappedTrie&) = delete;
+    MappedTrie& operator=(const MappedTrie&) = delete;
+
+    ~MappedTrie() { ::munmap(const_cast<char*>(base_), size_); }
+
+    const Node* root() const { return nodes_; }
+
+    const Node* descend(const Node* v, char c) const {
+        if (!v) return nullptr;
+        int idx = LowercaseAlphabet::index(c);
+        if (idx < 0) return nullptr;
+        uint32_t bit = uint32_t(1) << idx;
+        if (!(v->children & bit)) return nullptr;
+        return nodes_ + v->first_child + __builtin_popcount(v->children & (bit - 1));
+    }
+
+    const Node* descend_prefix(const std::string& pref) const {
+        const Node* v = root();
+        for (char ch : pref) {
+            v = descend(v, ch);
+            if (!v) return nullptr;
+        }
+        return v;
+    }
+
+    const Node* autocomplete(const Node* v) const { return autocomplete_with_priority(v).first; }
+
+    std::pair<const Node*, Counter> autocomplete_with_priority(const Node* v) const {
+        if (!v) return {nullptr, Counter{}};
+        auto [t, p] = best_of(index_of(v));
+        return {t ? nodes_ + t : nullptr, p};
+    }
+
+    bool is_terminal(const Node* v) const { return v && (v->children & trie_detail::snapshot_terminal_bit); }
+
+    // Palabra asociada a un terminal (apunta dentro del archivo mapeado).
+    std::string_view word(const Node* t) const { return {pool_ + t->str_offset, t->str_len}; }
+
+    Counter priority(const Node* t) const {
+        auto it = priority_overlay_.find(index_of(t));
+        return it != priority_overlay_.end() ? it->second : static_cast<Counter>(t->priority);
+    }
+
+    /**
+     * @brief Actualiza la prioridad de un terminal en el overlay.
+     * @return Cantidad de nodos visitados durante la propagación.
+     */
+    size_t update_priority(const Node* terminal) {
+        assert(is_terminal(terminal));
+        uint32_t t = index_of(terminal);
+        Counter p = priority(terminal);
+        PriorityPolicy::touch(p, global_access_counter_);
+        priority_overlay_[t] = p;
+
+        size_t visited = 0;
+        for (uint32_t v = t;; v = nodes_[v].parent) {
+            ++visited;
+            if (!recompute_best(v) || v == 0) break;
+        }
+        return visited;
+    }
+
+    size_t node_count() const { return node_count_; }
+
+    // Bytes mapeados del archivo.
+    size_t mapped_bytes() const { return size_; }
+
+    // Nodos con best_* modificado respecto del snapshot.
+    size_t overlay_size() const { return best_overlay_.size(); }
+
+private:
+    const char* base_ = nullptr;
+    size_t size_ = 0;
+    const SnapshotNode* nodes_ = nullptr;
+    size_t node_count_ = 0;
+    const char* pool_ = nullptr;
+    Counter global_access_counter_{};
+    std::unordered_map<uint32_t, Counter> priority_overlay_;
+    std::unordered_map<uint32_t, std::pair<uint32_t, Counter>> best_overlay_;
+
+    uint32_t index_of(const Node* v) const { return static_cast<uint32_t>(v - nodes_); }
+
+    std::pair<uint32_t, Counter> best_of(uint32_t v) const {
+        if (!best_overlay_.empty()) {
+            auto it = best_overlay_.find(v);
+            if (it != best_overlay_.end()) return it->second;
+        }
+        return {nodes_[v].best_terminal, static_cast<Counter>(nodes_[v].best_priority)};
+    }
+
+    // Recalcula best_* de v desde sus hijos; retorna si cambió.
+    bool recompute_best(uint32_t v) {
+        const Node& n = nodes_[v];
+        bool terminal = n.children & trie_detail::snapshot_terminal_bit;
+        uint32_t best = terminal ? v : 0;
+        Counter bestp = terminal ? priority(&n) : 0;
+        unsigned count = __builtin_popcount(n.children & ~trie_detail::snapshot_terminal_bit);
+        for (unsigned i = 0; i < count; ++i) {
+            auto [ut, up] = best_of(n.first_child + i);
+            if (ut && up > bestp) {
+                best = ut;
+                bestp = up;
+            }
+        }
+        if (best_of(v) == std::make_pair(best, bestp)) return false;
+        best_overlay_[v] = {best, bestp};
+        return true;
+    }
+};
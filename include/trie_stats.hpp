@@ -0,0 +1,50 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+
+// --- Instrumentación ---------------------------------------------------------
+// NoStats (por defecto) no agrega nada al Trie: los puntos de conteo se
+// descartan en compilación. CollectStats cuenta el trabajo del camino caliente
+// en un TrieStats que se lee con Trie::stats(). Los contadores no son
+// atómicos, así que no se admite junto con ThreadSafe.
+
+// Marca común para que el Trie reconozca la opción de instrumentación.
+struct InstrumentationOption {};
+
+struct NoStats : InstrumentationOption {
+    static constexpr bool enabled = false;
+};
+
+struct CollectStats : InstrumentationOption {
+    static constexpr bool enabled = true;
+};
+
+/**
+ * @struct TrieStats
+ * @brief Contadores acumulados desde la construcción o el último reset_stats().
+ */
+struct TrieStats {
+    uint64_t prefix_descents = 0;       // llamadas a descend_prefix
+    uint64_t prefix_nodes = 0;          // nodos alcanzados por ellas (sin la raíz)
+    uint64_t propagations = 0;          // propagaciones hacia la raíz
+    uint64_t propagation_nodes = 0;     // nodos visitados por ellas
+    uint64_t max_propagation_depth = 0; // la más larga
+    uint64_t recomputes = 0;            // recompute_best (o su versión top-k)
+    uint64_t slots_scanned = 0;         // casilleros de hijos leídos por recompute_best
+    uint64_t best_changes = 0;          // veces que cambió el best_terminal de un nodo
+
+    void note_propagation(uint64_t visited) {
+        ++propagations;
+        propagation_nodes += visited;
+        max_propagation_depth = std::max(max_propagation_depth, visited);
+    }
+};
+
+namespace trie_detail {
+// Lo que guarda el Trie: TrieStats o nada.
+struct NoStatsStorage {};
+
+template <typename Instrumentation>
+using stats_storage_t = std::conditional_t<Instrumentation::enabled, TrieStats, NoStatsStorage>;
+} // namespace trie_detail
@@ -0,0 +1,87 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <type_traits>
+
+// --- Modo de concurrencia --------------------------------------------------
+// SingleThreaded (por defecto) deja el Trie como siempre. ThreadSafe permite
+// que varios hilos lean (root, descend, descend_prefix, autocomplete) sin
+// bloqueo mientras los escritores (insert, update_priority) se serializan con
+// un mutex.
+
+// Marca común para que el Trie reconozca la opción de concurrencia.
+struct SyncOption {};
+
+struct SingleThreaded : SyncOption {
+    static constexpr bool enabled = false;
+};
+
+struct ThreadSafe : SyncOption {
+    static constexpr bool enabled = true;
+};
+
+namespace trie_detail {
+
+// Par (mejor terminal, prioridad) leído de una sola vez.
+template <typename Link, typename Counter>
+struct Best {
+    Link terminal;
+    Counter priority;
+};
+
+/**
+ * @brief Campos best_* tal como siempre: dos miembros independientes.
+ */
+template <typename Link, typename Counter>
+struct PlainBest {
+    Link best_terminal{};               // mejor terminal del subárbol
+    Counter best_priority = 0;          // prioridad de ese mejor terminal
+
+    Best<Link, Counter> load_best() const { return {best_terminal, best_priority}; }
+    void store_best(Link t, Counter p) {
+        best_terminal = t;
+        best_priority = p;
+    }
+};
+
+/**
+ * @brief Par best_* empaquetado en una palabra de 64 bits atómica.
+ *
+ * Los 32 bits bajos guardan el enlace y los altos la prioridad, de modo que un
+ * lector nunca ve un terminal con la prioridad de otro. Las prioridades se
+ * saturan en 2^32 - 1; a partir de ahí los empates se resuelven por orden de
+ * hijos.
+ */
+template <typename Link, typename Counter>
+struct PackedBest {
+    static_assert(sizeof(Link) == 4, "ThreadSafe requiere enlaces de 32 bits (ArenaStorage)");
+    static_assert(std::is_integral_v<Counter>, "ThreadSafe requiere prioridades enteras");
+
+    std::atomic<uint64_t> best_packed{0};
+
+    Best<Link, Counter> load_best() const {
+        uint64_t x = best_packed.load(std::memory_order_acquire);
+        return {static_cast<Link>(x & 0xFFFFFFFFu), static_cast<Counter>(x >> 32)};
+    }
+    void store_best(Link t, Counter p) {
+        uint64_t sat = std::min<uint64_t>(static_cast<uint64_t>(p), std::numeric_limits<uint32_t>::max());
+        best_packed.store((sat << 32) | static_cast<uint64_t>(t), std::memory_order_release);
+    }
+};
+
+template <typename Sync, typename Link, typename Counter>
+using best_base_t = std::conditional_t<Sync::enabled, PackedBest<Link, Counter>, PlainBest<Link, Counter>>;
+
+// Candado vacío para el modo de un solo hilo.
+struct NoLock {
+    void lock() {}
+    void unlock() {}
+};
+
+template <typename Sync>
+using write_lock_t = std::conditional_t<Sync::enabled, std::mutex, NoLock>;
+
+} // namespace trie_detail
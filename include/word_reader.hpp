@@ -0,0 +1,136 @@
+#pragma once
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// --- Lectura de palabras en streaming ----------------------------------------
+// Equivale a `while (file >> word)` con el locale "C": las palabras son
+// secuencias maximales de bytes que no son ' ', '\t', '\n', '\v', '\f' ni '\r'.
+
+namespace reader_detail {
+
+inline bool is_space(unsigned char c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+
+#if defined(__SSE2__)
+// Máscara de 16 bits con los bytes de [p, p + 16) que son espacio.
+inline unsigned space_mask(const char* p) {
+    __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i t = _mm_sub_epi8(b, _mm_set1_epi8('\t'));                      // '\t'..'\r' -> 0..4
+    __m128i ctrl = _mm_cmpeq_epi8(_mm_min_epu8(t, _mm_set1_epi8(4)), t);   // t <= 4 (sin signo)
+    __m128i blank = _mm_cmpeq_epi8(b, _mm_set1_epi8(' '));
+    return static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(ctrl, blank)));
+}
+#endif
+
+// Primer byte en [p, end) que (no) es espacio según `want_space`, o end.
+inline const char* scan(const char* p, const char* end, bool want_space) {
+#if defined(__SSE2__)
+    for (; end - p >= 16; p += 16) {
+        unsigned m = space_mask(p);
+        if (!want_space) m = ~m & 0xFFFFu;
+        if (m) return p + __builtin_ctz(m);
+    }
+#endif
+    while (p < end && is_space(static_cast<unsigned char>(*p)) != want_space) ++p;
+    return p;
+}
+
+} // namespace reader_detail
+
+/**
+ * @class WordReader
+ * @brief Lee un archivo por bloques grandes y entrega sus palabras en lotes
+ * de string_view que apuntan al buffer interno.
+ *
+ * La memoria usada es la del buffer (más lo que ocupe la palabra más larga),
+ * sin importar el tamaño del archivo. Las vistas de un lote son válidas hasta
+ * la siguiente llamada a next_batch().
+ */
+class WordReader {
+public:
+    explicit WordReader(const std::string& filename, size_t buffer_bytes = size_t(1) << 20)
+        : file_(std::fopen(filename.c_str(), "rb")), buffer_(buffer_bytes) {}
+
+    WordReader(const WordReader&) = delete;
+    WordReader& operator=(const WordReader&) = delete;
+
+    ~WordReader() {
+        if (file_) std::fclose(file_);
+    }
+
+    bool is_open() const { return file_ != nullptr; }
+
+    /**
+     * @brief Llena `batch` con hasta `max_words` palabras.
+     * @return false si no quedaban palabras.
+     */
+    bool next_batch(std::vector<std::string_view>& batch, size_t max_words = 4096) {
+        batch.clear();
+        while (batch.size() < max_words) {
+            const char* end = buffer_.data() + filled_;
+            const char* p = reader_detail::scan(buffer_.data() + pos_, end, false);
+            const char* q = reader_detail::scan(p, end, true);
+            if (q == end && !eof_) {
+                // Palabra posiblemente cortada por el bloque: hay que leer más,
+                // lo que mueve el buffer, así que primero se entrega el lote.
+                pos_ = static_cast<size_t>(p - buffer_.data());
+                if (!batch.empty()) break;
+                refill();
+                continue;
+            }
+            pos_ = static_cast<size_t>(q - buffer_.data());
+            if (p == q) break;              // fin de archivo
+            batch.emplace_back(p, static_cast<size_t>(q - p));
+        }
+        return !batch.empty();
+    }
+
+    // Bytes leídos del archivo hasta ahora.
+    size_t bytes_read() const { return bytes_read_; }
+
+private:
+    std::FILE* file_;
+    std::vector<char> buffer_;
+    size_t pos_ = 0;        // próximo byte sin procesar
+    size_t filled_ = 0;     // bytes válidos en el buffer
+    size_t bytes_read_ = 0;
+    bool eof_ = false;
+
+    // Conserva lo no procesado al inicio del buffer y lee a continuación.
+    void refill() {
+        size_t rest = filled_ - pos_;
+        std::memmove(buffer_.data(), buffer_.data() + pos_, rest);
+        pos_ = 0;
+        filled_ = rest;
+        if (filled_ == buffer_.size()) buffer_.resize(2 * buffer_.size());   // palabra más larga que el buffer
+        size_t got = file_ ? std::fread(buffer_.data() + filled_, 1, buffer_.size() - filled_, file_) : 0;
+        filled_ += got;
+        bytes_read_ += got;
+        if (got == 0) eof_ = true;
+    }
+};
+
+/**
+ * @brief Recorre las palabras de un archivo por lotes.
+ * @param f Se llama con cada lote (const std::vector<std::string_view>&).
+ * @return Cantidad total de palabras, o 0 si el archivo no se pudo abrir.
+ */
+template <typename F>
+size_t for_each_word_batch(const std::string& filename, F&& f, size_t batch_words = 4096) {
+    WordReader reader(filename);
+    if (!reader.is_open()) return 0;
+    std::vector<std::string_view> batch;
+    size_t total = 0;
+    while (reader.next_batch(batch, batch_words)) {
+        total += batch.size();
+        f(static_cast<const std::vector<std::string_view>&>(batch));
+    }
+    return total;
+}
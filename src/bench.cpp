@@ -0,0 +1,353 @@
+#include "trie.hpp"
+#include "latency_histogram.hpp"
+#include "word_reader.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace std::chrono;
+
+// --- Microbenchmarks del Trie ----------------------------------------------
+// Cada benchmark repite la misma carga `reps` veces, tras `warmup`
+// repeticiones descartadas. En cada repetición hay dos pasadas sobre un
+// estado preparado igual (setup, sin cronometrar): una sin relojes por
+// operación, que da ops/s, y otra que cronometra cada operación y la anota en
+// un LatencyHistogram (se le resta el costo de leer el reloj). Se reporta la
+// mediana y el rango de ops/s entre repeticiones y los percentiles del
+// histograma de todas las repeticiones juntas.
+//
+// Uso: bench [--reps N] [--warmup N] [--ops N] [--words archivo]
+//            [--text archivo] [--commit id] [--baseline out/bench.csv]
+//            [--tolerance 0.15]
+// Con --baseline compara contra una corrida anterior y termina con código 2
+// si algún benchmark empeoró más que la tolerancia en p50, p99 u ops/s.
+
+struct BenchConfig {
+    size_t reps = 5;
+    size_t warmup = 1;
+    size_t max_ops = 0;                 // 0 = todas las palabras
+    string words_file = "datos/words.txt";
+    string text_file = "datos/wikipedia.txt";
+    string commit = "desconocido";
+    string baseline;
+    double tolerance = 0.15;
+};
+
+struct BenchResult {
+    string benchmark;
+    string policy;
+    size_t reps;
+    size_t ops;                         // operaciones por repetición
+    double ops_per_s;                   // mediana entre repeticiones
+    double ops_per_s_min;
+    double ops_per_s_max;
+    double mean_ns;
+    uint64_t p50_ns;
+    uint64_t p90_ns;
+    uint64_t p99_ns;
+    uint64_t p999_ns;
+    uint64_t max_ns;
+};
+
+// Impide que el compilador descarte un resultado que no se usa.
+template <typename T>
+inline void keep(const T& v) {
+    asm volatile("" : : "r,m"(v) : "memory");
+}
+
+inline uint64_t now_ns() {
+    return static_cast<uint64_t>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+// Costo de dos lecturas seguidas del reloj: el mínimo de muchas muestras.
+uint64_t clock_overhead() {
+    uint64_t best = UINT64_MAX;
+    for (int i = 0; i < 100000; ++i) {
+        uint64_t t0 = now_ns();
+        uint64_t t1 = now_ns();
+        best = min(best, t1 - t0);
+    }
+    return best;
+}
+
+/**
+ * @brief Corre un benchmark y resume sus repeticiones.
+ * @param ops Operaciones por repetición.
+ * @param setup Prepara el estado antes de cada pasada (no se cronometra).
+ * @param op op(i) ejecuta la operación i.
+ */
+template <typename Setup, typename Op>
+BenchResult run_bench(const string& benchmark, const string& policy, const BenchConfig& cfg,
+                      uint64_t overhead, size_t ops, Setup&& setup, Op&& op) {
+    cout << "  " << benchmark << " (" << policy << ", " << ops << " ops)..." << flush;
+    LatencyHistogram<> hist;
+    vector<double> rates;
+    for (size_t rep = 0; rep < cfg.warmup + cfg.reps; ++rep) {
+        bool measured = rep >= cfg.warmup;
+
+        setup();
+        uint64_t t_start = now_ns();
+        for (size_t i = 0; i < ops; ++i) op(i);
+        uint64_t elapsed = now_ns() - t_start;
+        if (measured) rates.push_back(elapsed ? ops * 1e9 / elapsed : 0.0);
+
+        setup();
+        for (size_t i = 0; i < ops; ++i) {
+            uint64_t t0 = now_ns();
+            op(i);
+            uint64_t t1 = now_ns();
+            if (measured) hist.record(t1 - t0 > overhead ? t1 - t0 - overhead : 0);
+        }
+    }
+    sort(rates.begin(), rates.end());
+
+    BenchResult r;
+    r.benchmark = benchmark;
+    r.policy = policy;
+    r.reps = cfg.reps;
+    r.ops = ops;
+    r.ops_per_s = rates.empty() ? 0.0 : rates[rates.size() / 2];
+    r.ops_per_s_min = rates.empty() ? 0.0 : rates.front();
+    r.ops_per_s_max = rates.empty() ? 0.0 : rates.back();
+    r.mean_ns = hist.mean();
+    r.p50_ns = hist.percentile(0.5);
+    r.p90_ns = hist.percentile(0.9);
+    r.p99_ns = hist.percentile(0.99);
+    r.p999_ns = hist.percentile(0.999);
+    r.max_ns = hist.max();
+    cout << " " << fixed << setprecision(0) << r.ops_per_s << " ops/s, p50 " << r.p50_ns << " ns, p99 "
+         << r.p99_ns << " ns, p999 " << r.p999_ns << " ns" << endl;
+    return r;
+}
+
+/**
+ * @brief Benchmarks de una política: insert, descend, autocomplete,
+ * update_priority y la simulación de tecleo completa.
+ * @details insert parte de un trie vacío en cada pasada; los demás usan un
+ * trie con el diccionario cargado. descend baja cada palabra del diccionario
+ * carácter a carácter; autocomplete consulta prefijos de las palabras del
+ * texto (de largo variable, ya descendidos); update_priority y el tecleo
+ * recorren el texto en orden sobre una copia (Trie::clone) de ese trie que
+ * setup rehace antes de cada pasada, así todas parten de las mismas
+ * prioridades.
+ */
+template <typename Policy>
+vector<BenchResult> bench_policy(const BenchConfig& cfg, uint64_t overhead, const vector<string>& words,
+                                 const vector<string>& text) {
+    using TrieT = Trie<Policy>;
+    const string policy = Policy::name();
+    auto cap = [&](size_t n) { return cfg.max_ops ? min(n, cfg.max_ops) : n; };
+    vector<BenchResult> results;
+
+    unique_ptr<TrieT> fresh;
+    results.push_back(run_bench("insert", policy, cfg, overhead, cap(words.size()),
+                                [&] { fresh = make_unique<TrieT>(); },
+                                [&](size_t i) { fresh->insert(words[i]); }));
+    fresh.reset();
+
+    TrieT trie;
+    trie.build_from_sorted(words);
+    auto nothing = [] {};
+
+    results.push_back(run_bench("descend", policy, cfg, overhead, cap(words.size()), nothing, [&](size_t i) {
+        auto* v = trie.root();
+        for (char c : words[i]) {
+            if (!(v = trie.descend(v, c))) break;
+        }
+        keep(v);
+    }));
+
+    vector<typename TrieT::Node*> prefixes;
+    for (size_t i = 0; i < text.size(); ++i) {
+        const string& w = text[i];
+        if (w.empty()) continue;
+        if (auto* v = trie.descend_prefix(w.substr(0, 1 + i % w.size()))) prefixes.push_back(v);
+    }
+    results.push_back(run_bench("autocomplete", policy, cfg, overhead, cap(prefixes.size()), nothing,
+                                [&](size_t i) { keep(trie.autocomplete(prefixes[i])); }));
+
+    // Los terminales se buscan de nuevo en cada copia
+    unique_ptr<TrieT> used;
+    vector<typename TrieT::Node*> terminals;
+    auto fresh_copy = [&] {
+        used.reset(new TrieT(trie.clone()));
+        terminals.clear();
+        for (const auto& w : text) {
+            if (auto* t = used->descend(used->descend_prefix(w), '$')) terminals.push_back(t);
+        }
+    };
+    fresh_copy();
+    results.push_back(run_bench("update_priority", policy, cfg, overhead, cap(terminals.size()), fresh_copy,
+                                [&](size_t i) { used->update_priority(terminals[i]); }));
+
+    // Una operación = una palabra del texto, igual que replay_autocomplete en
+    // experimentos: descender y autocompletar por carácter hasta acertar, y
+    // registrar el uso en el '$' del último nodo alcanzado.
+    auto fresh_trie = [&] { used.reset(new TrieT(trie.clone())); };
+    results.push_back(run_bench("keystroke_replay", policy, cfg, overhead, cap(text.size()), fresh_trie,
+                                [&](size_t i) {
+        const string& w = text[i];
+        auto* v = used->root();
+        for (char c : w) {
+            if (!(v = used->descend(v, c))) break;
+            auto* t = used->autocomplete(v);
+            if (t && used->word(t) == w) break;
+        }
+        if (v) {
+            if (auto* t = used->descend(v, '$')) used->update_priority(t);
+        }
+    }));
+    return results;
+}
+
+vector<string> load_words(const string& filename) {
+    vector<string> words;
+    for_each_word_batch(filename, [&](const vector<string_view>& batch) {
+        for (string_view w : batch) words.emplace_back(w);
+    });
+    return words;
+}
+
+void save_bench_csv(const string& filename, const BenchConfig& cfg, const vector<BenchResult>& results) {
+    ofstream file(filename);
+    file << "commit,benchmark,policy,reps,ops,ops_per_s,ops_per_s_min,ops_per_s_max,"
+            "mean_ns,p50_ns,p90_ns,p99_ns,p999_ns,max_ns\n";
+    file << fixed << setprecision(1);
+    for (const auto& r : results) {
+        file << cfg.commit << "," << r.benchmark << "," << r.policy << "," << r.reps << "," << r.ops << ","
+             << r.ops_per_s << "," << r.ops_per_s_min << "," << r.ops_per_s_max << "," << r.mean_ns << ","
+             << r.p50_ns << "," << r.p90_ns << "," << r.p99_ns << "," << r.p999_ns << "," << r.max_ns << "\n";
+    }
+    cout << "Resultados guardados en " << filename << endl;
+}
+
+void save_bench_json(const string& filename, const BenchConfig& cfg, uint64_t overhead,
+                     const vector<BenchResult>& results) {
+    ofstream file(filename);
+    file << fixed << setprecision(1);
+    file << "{\n  \"commit\": \"" << cfg.commit << "\",\n  \"reps\": " << cfg.reps
+         << ",\n  \"warmup\": " << cfg.warmup << ",\n  \"clock_overhead_ns\": " << overhead
+         << ",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        file << "    {\"benchmark\": \"" << r.benchmark << "\", \"policy\": \"" << r.policy
+             << "\", \"ops\": " << r.ops << ", \"ops_per_s\": " << r.ops_per_s
+             << ", \"ops_per_s_min\": " << r.ops_per_s_min << ", \"ops_per_s_max\": " << r.ops_per_s_max
+             << ", \"mean_ns\": " << r.mean_ns << ", \"p50_ns\": " << r.p50_ns << ", \"p90_ns\": " << r.p90_ns
+             << ", \"p99_ns\": " << r.p99_ns << ", \"p999_ns\": " << r.p999_ns << ", \"max_ns\": " << r.max_ns
+             << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    file << "  ]\n}\n";
+    cout << "Resultados guardados en " << filename << endl;
+}
+
+/**
+ * @brief Compara contra un CSV de una corrida anterior.
+ * @return Cantidad de benchmarks que empeoraron más que la tolerancia.
+ * @details ops/s empeora si hasta la mejor repetición queda bajo la mediana
+ * anterior menos la tolerancia; p50 o p99, si crecen más que la tolerancia
+ * y 5 ns (las operaciones más cortas están cerca de la resolución del reloj).
+ */
+size_t compare_baseline(const BenchConfig& cfg, const vector<BenchResult>& results) {
+    ifstream file(cfg.baseline);
+    if (!file.is_open()) {
+        cerr << "Error: no se pudo abrir " << cfg.baseline << endl;
+        return 0;
+    }
+    map<pair<string, string>, vector<string>> old;
+    string line;
+    getline(file, line);                // encabezado
+    while (getline(file, line)) {
+        vector<string> f;
+        stringstream ss(line);
+        for (string cell; getline(ss, cell, ',');) f.push_back(cell);
+        if (f.size() >= 14) old[{f[1], f[2]}] = f;
+    }
+
+    string old_commit = old.empty() ? "?" : old.begin()->second[0];
+    cout << "\nComparación con " << old_commit << " (tolerancia " << cfg.tolerance * 100 << " %):" << endl;
+    size_t regressions = 0;
+    for (const auto& r : results) {
+        auto it = old.find({r.benchmark, r.policy});
+        if (it == old.end()) continue;
+        double old_rate = stod(it->second[5]), old_p50 = stod(it->second[9]), old_p99 = stod(it->second[11]);
+        bool worse = r.ops_per_s_max < old_rate * (1.0 - cfg.tolerance) ||
+                     r.p50_ns > old_p50 * (1.0 + cfg.tolerance) + 5 ||
+                     r.p99_ns > old_p99 * (1.0 + cfg.tolerance) + 5;
+        regressions += worse;
+        cout << "  " << (worse ? "REGRESIÓN " : "ok        ") << r.benchmark << " (" << r.policy << "): "
+             << setprecision(1) << 100.0 * (r.ops_per_s / old_rate - 1.0) << " % ops/s, p50 " << old_p50
+             << " -> " << r.p50_ns << " ns, p99 " << old_p99 << " -> " << r.p99_ns << " ns" << endl;
+    }
+    return regressions;
+}
+
+void print_usage(ostream& out) {
+    out << "Uso: bench [--reps N] [--warmup N] [--ops N] [--words archivo]\n"
+           "           [--text archivo] [--commit id] [--baseline out/bench.csv]\n"
+           "           [--tolerance 0.15]" << endl;
+}
+
+int main(int argc, char** argv) {
+    BenchConfig cfg;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (i + 1 >= argc) {
+            cerr << "Falta el valor de " << arg << endl;
+            print_usage(cerr);
+            return 1;
+        }
+        string value = argv[++i];
+        try {
+            if (arg == "--reps") cfg.reps = stoul(value);
+            else if (arg == "--warmup") cfg.warmup = stoul(value);
+            else if (arg == "--ops") cfg.max_ops = stoul(value);
+            else if (arg == "--words") cfg.words_file = value;
+            else if (arg == "--text") cfg.text_file = value;
+            else if (arg == "--commit") cfg.commit = value.empty() ? cfg.commit : value;
+            else if (arg == "--baseline") cfg.baseline = value;
+            else if (arg == "--tolerance") cfg.tolerance = stod(value);
+            else {
+                cerr << "Opción desconocida: " << arg << endl;
+                print_usage(cerr);
+                return 1;
+            }
+        } catch (const exception&) {
+            cerr << "Valor inválido para " << arg << ": " << value << endl;
+            print_usage(cerr);
+            return 1;
+        }
+    }
+    if (cfg.reps == 0) cfg.reps = 1;
+
+    vector<string> words = load_words(cfg.words_file);
+    vector<string> text = load_words(cfg.text_file);
+    if (words.empty() || text.empty()) {
+        cerr << "Error: no se pudieron cargar " << cfg.words_file << " y " << cfg.text_file << endl;
+        return 1;
+    }
+    uint64_t overhead = clock_overhead();
+    cout << "=== BENCHMARKS (" << cfg.commit << ") ===" << endl;
+    cout << words.size() << " palabras, " << text.size() << " palabras de texto, " << cfg.reps
+         << " repeticiones + " << cfg.warmup << " de calentamiento, reloj " << overhead << " ns" << endl;
+
+    vector<BenchResult> results;
+    for (auto& r : bench_policy<FrequencyPolicy>(cfg, overhead, words, text)) results.push_back(r);
+    for (auto& r : bench_policy<RecentPolicy>(cfg, overhead, words, text)) results.push_back(r);
+
+    // La base se lee antes de escribir: puede ser el mismo out/bench.csv
+    size_t regressions = cfg.baseline.empty() ? 0 : compare_baseline(cfg, results);
+    std::filesystem::create_directories("out");
+    save_bench_csv("out/bench.csv", cfg, results);
+    save_bench_json("out/bench.json", cfg, overhead, results);
+    return regressions > 0 ? 2 : 0;
+}
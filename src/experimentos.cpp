@@ -1,4 +1,12 @@
 #include "trie.hpp"
+#include "radix_trie.hpp"
+#include "sharded_trie.hpp"
+#include "trie_snapshot.hpp"
+#include "dawg.hpp"
+#include "double_array_trie.hpp"
+#include "word_reader.hpp"
+#include "perf_counters.hpp"
+#include "priority_log.hpp"
 #include <iostream>
 #include <fstream>
 #include <chrono>
@@ -6,6 +14,16 @@
 #include <string>
 #include <iomanip>
 #include <filesystem>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <random>
+#include <memory>
+#include <functional>
+#include <sstream>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
 
 
 using namespace std;
@@ -17,6 +35,10 @@ struct MemoryResult {
     size_t chars_inserted;
     size_t node_count;
     double nodes_per_char;
+    size_t bytes_used;
+    size_t topk_bytes;
+    size_t string_bytes;            // arena de strings del Trie
+    size_t string_bytes_deque;      // estimación con std::deque<std::string>
 };
 
 // Estructura para almacenar resultados de tiempo
@@ -27,20 +49,254 @@ struct TimeResult {
     double time_per_char_ms;
 };
 
+// Estructura para comparar representaciones de nodo
+struct LayoutResult {
+    string layout;
+    size_t node_count;
+    size_t bytes_used;
+    double build_ms;
+    double descend_ns_per_char;
+};
+
+// Estructura para comparar alfabetos (tabla vs isalpha/tolower)
+struct AlphabetResult {
+    string alphabet;
+    string layout;
+    size_t sigma;
+    size_t node_size;           // sizeof(Node)
+    size_t node_count;
+    size_t bytes_used;
+    double map_ns_per_char;     // solo traducir caracteres a índices
+    double descend_ns_per_char;
+};
+
+// Estructura para borrado y compactación
+struct ChurnResult {
+    string storage;
+    string stage;               // inicial, churn, borrado o compactado
+    size_t node_count;
+    size_t free_nodes;
+    size_t node_bytes;          // bytes_used(): nodos, lista libre e hijos
+    size_t string_bytes;
+    double descend_ns_per_char;
+    double compact_ms;
+};
+
+// Estructura para comparar el Trie con su DAWG exportado
+struct DawgResult {
+    string snapshot;            // prioridades con que se exportó
+    string structure;
+    size_t states;              // nodos del trie o estados del autómata
+    size_t transitions;
+    size_t bytes_used;          // trie: nodos + hijos (sin la arena de strings)
+    double build_ms;
+    double ns_per_char;
+    size_t suggested;           // prefijos cuya sugerencia era la palabra tecleada
+};
+
+// Estructura para comparar Trie y RadixTrie
+struct RadixResult {
+    string structure;
+    string dataset;
+    size_t node_count;
+    double replay_ms;
+    double update_ns;
+    size_t chars_typed;
+};
+
+// Estructura para comparar el trie de punteros con el de arreglo doble
+struct DoubleArrayResult {
+    string structure;
+    string dataset;
+    size_t node_count;
+    size_t bytes_used;          // sin la arena de strings
+    double build_ms;            // double_array: conversión desde el trie
+    double descend_ns_per_char;
+    double replay_ms;
+    double update_ns;
+    size_t chars_typed;
+};
+
+// Estructura para el costo de propagar prioridades
+struct PropagationResult {
+    string policy;
+    string mode;
+    string dataset;
+    size_t updates;
+    double avg_visited;
+    double update_ns;
+};
+
+// Estructura para los contadores de Trie<..., CollectStats>
+struct TrieStatsResult {
+    string policy;
+    string mode;
+    string dataset;
+    size_t updates;
+    double avg_prefix_nodes;        // nodos por descend_prefix
+    double avg_propagation;         // nodos por propagación
+    size_t max_propagation;
+    double recomputes_per_update;
+    double slots_per_recompute;     // casilleros leídos por recompute_best
+    double best_changes_per_update;
+};
+
+// Estructura para los contadores de hardware de una fase
+struct PerfPhaseResult {
+    string phase;
+    bool available;
+    double ms;
+    std::array<uint64_t, PerfCounters::EventCount> values;
+};
+
+// Estructura para la construcción paralela
+struct ParallelBuildResult {
+    string storage;
+    unsigned threads;
+    double time_ms;
+    double speedup;         // respecto a insert() palabra a palabra
+};
+
+// Estructura para carga desde snapshot
+struct SnapshotResult {
+    string method;
+    double load_ms;
+    double first_query_us;
+    size_t bytes;
+};
+
+// Estructura para la velocidad de lectura de palabras
+struct LoaderResult {
+    string method;
+    string file;
+    size_t words;
+    double megabytes;
+    double time_ms;
+    double mb_per_s;
+};
+
+// Estructura para consultas por lotes con prefetch
+struct BatchResult {
+    string dataset;
+    string mode;
+    size_t batch;
+    size_t chars_typed;
+    double time_ms;
+    double lookups_per_s;   // teclas simuladas (descend + autocomplete) por segundo
+};
+
+// Estructura para la tabla de prefijos cortos
+struct PrefixCacheResult {
+    string policy;
+    string dataset;
+    size_t depth;               // 0 = sin tabla
+    size_t lookups;             // teclas simuladas (lookup_prefix)
+    double hit_rate;            // fracción respondida por la tabla
+    size_t chars_typed;
+    double keystroke_ns;        // simulación completa (consulta + update_priority) por tecla
+    double short_lookup_ns;     // solo consultas de hasta 3 caracteres, sin actualizar
+    double short_suggested;     // fracción de esas consultas con sugerencia
+    size_t table_bytes;
+};
+
+// Estructura para propagación diferida
+struct DeferredResult {
+    string dataset;
+    size_t flush_every;         // 0 = propagación inmediata
+    double time_ms;
+    double updates_per_s;
+    size_t flushes;
+    double flush_us;            // costo promedio de un flush
+    double nodes_per_flush;
+    double percentage;
+};
+
+// Estructura para comparar políticas de prioridad
+struct PolicyResult {
+    string dataset;
+    string policy;
+    uint32_t half_life;         // solo FrecencyPolicy (0 en las demás)
+    size_t chars_typed;
+    double percentage;
+    double saved_percentage;    // teclas ahorradas: 100 - percentage
+    double time_ms;
+    size_t renormalizations;
+};
+
+// Estructura para lectores concurrentes
+struct ConcurrencyResult {
+    unsigned readers;
+    double duration_ms;
+    double reads_per_s;
+    double updates_per_s;
+};
+
+// Estructura para escalabilidad de escritores
+struct ShardingResult {
+    string structure;
+    unsigned threads;
+    size_t updates;
+    double time_ms;
+    double updates_per_s;
+};
+
+// Estructura para el log de prioridades
+struct PriorityLogResult {
+    string dataset;
+    string phase;
+    string mode;
+    size_t records;
+    double ns_per_record;
+    double records_per_s;
+    uint64_t groups;
+    uint64_t bytes;
+    double time_ms;
+    size_t recomputed;
+};
+
 // Estructura para resultados de autocompletado
 struct AutocompleteResult {
     size_t words_processed;
     size_t total_chars_in_text;
     size_t chars_typed;
     double percentage;
+    size_t keystrokes = 0;      // prefijos consultados
+    double table_hit_rate = 0;  // fracción respondida por la tabla de prefijos
+    double keystroke_ns = 0;    // tiempo de la simulación por tecla
+    size_t updates = 0;         // llamadas a update_priority hechas por la simulación
 };
 
+// Profundidad de la tabla de prefijos de TrieT (0 sin tabla, p.ej. TimedFlush).
+template<typename TrieT, typename = void>
+constexpr size_t prefix_cache_depth_v = 0;
+template<typename TrieT>
+constexpr size_t prefix_cache_depth_v<TrieT, void_t<decltype(TrieT::prefix_cache_depth)>> =
+    TrieT::prefix_cache_depth;
+
 /**
  * @brief Carga todas las palabras de un archivo de texto (una por línea).
  * @param path Ruta del archivo.
  * @return Vector con todas las palabras cargadas.
  */
 vector<string> read_words(const string& filename) {
+    vector<string> words;
+    WordReader reader(filename);
+    if (!reader.is_open()) {
+        cerr << "Error: no se pudo abrir " << filename << endl;
+        return words;
+    }
+    
+    vector<string_view> batch;
+    while (reader.next_batch(batch)) {
+        for (string_view w : batch) {
+            words.emplace_back(w);
+        }
+    }
+    return words;
+}
+
+// Lector original con ifstream >> word (referencia para el experimento de lectura)
+vector<string> read_words_ifstream(const string& filename) {
     vector<string> words;
     ifstream file(filename);
     if (!file.is_open()) {
@@ -66,19 +322,22 @@ size_t count_chars(const vector<string>& words, size_t start, size_t end) {
 }
 
 /**
- * Realiza el experimento de memoria midiendo node_count
- * en potencias de 2.
+ * Realiza el experimento de memoria midiendo node_count y los bytes
+ * usados por los nodos en potencias de 2.
+ * @tparam Options Opciones del Trie (p.ej. ArenaStorage).
  * @param words: vector de palabras del dataset.
- * @return vector de resultados (palabras, caracteres, nodos, ratio).
+ * @param log Salida del progreso (el búfer del trabajo al correr en paralelo).
+ * @return vector de resultados (palabras, caracteres, nodos, ratio, bytes).
  */
-template<typename Policy>
-vector<MemoryResult> experiment_memory(const vector<string>& words) {
-    cout << "Iniciando experimento de memoria con política " << Policy::name() << "..." << endl;
+template<typename Policy, typename... Options>
+vector<MemoryResult> experiment_memory(const vector<string>& words, ostream& log = cout) {
+    log << "Iniciando experimento de memoria con política " << Policy::name() << "..." << endl;
     
-    Trie<Policy> trie;
+    Trie<Policy, Options...> trie;
     vector<MemoryResult> results;
     size_t N = words.size();
     size_t total_chars = 0;
+    size_t deque_bytes = 0;
     
     // Puntos de medición: 2^0, 2^1, ..., 2^17, N
     vector<size_t> checkpoints;
@@ -92,6 +351,8 @@ vector<MemoryResult> experiment_memory(const vector<string>& words) {
     for (size_t i = 0; i < N; ++i) {
         trie.insert(words[i]);
         total_chars += words[i].length();
+        // Antes cada inserción copiaba la palabra a un std::string (SSO de 15 bytes)
+        deque_bytes += sizeof(string) + (words[i].length() > 15 ? words[i].length() + 1 : 0);
         
         size_t current_count = i + 1;
         if (next_checkpoint_idx < checkpoints.size() && 
@@ -102,11 +363,16 @@ vector<MemoryResult> experiment_memory(const vector<string>& words) {
             res.chars_inserted = total_chars;
             res.node_count = trie.node_count();
             res.nodes_per_char = static_cast<double>(res.node_count) / res.chars_inserted;
+            res.bytes_used = trie.bytes_used();
+            res.topk_bytes = trie.topk_bytes();
+            res.string_bytes = trie.string_bytes();
+            res.string_bytes_deque = deque_bytes;
             
             results.push_back(res);
-            cout << "  Checkpoint " << current_count << ": " 
+            log << "  Checkpoint " << current_count << ": " 
                  << res.node_count << " nodos, "
-                 << res.nodes_per_char << " nodos/char" << endl;
+                 << res.nodes_per_char << " nodos/char, "
+                 << res.bytes_used << " bytes" << endl;
             
             ++next_checkpoint_idx;
         }
@@ -121,11 +387,16 @@ vector<MemoryResult> experiment_memory(const vector<string>& words) {
  * @tparam Policy Política de prioridad (FrequencyPolicy o RecentPolicy).
  * @param words Vector con todas las palabras del dataset base.
  * @param output Ruta del CSV donde guardar los resultados.
+ * @param bulk Si es true cada bloque se carga con build_from_sorted en vez de
+ * insert palabra a palabra (conviene pasar words ordenado).
+ * @param log Salida del progreso.
  * @details Divide las inserciones en M=16 bloques y mide tiempo por bloque.
  */
 template<typename Policy>
-vector<TimeResult> experiment_time(const vector<string>& words, int M = 16) {
-    cout << "Iniciando experimento de tiempo con política " << Policy::name() << "..." << endl;
+vector<TimeResult> experiment_time(const vector<string>& words, int M = 16, bool bulk = false,
+                                  ostream& log = cout) {
+    log << "Iniciando experimento de tiempo con política " << Policy::name()
+         << (bulk ? " (carga en bloque)" : "") << "..." << endl;
     
     Trie<Policy> trie;
     vector<TimeResult> results;
@@ -140,8 +411,12 @@ vector<TimeResult> experiment_time(const vector<string>& words, int M = 16) {
         
         auto t_start = high_resolution_clock::now();
         
-        for (size_t i = start; i < end; ++i) {
-            trie.insert(words[i]);
+        if (bulk) {
+            trie.build_from_sorted(words.begin() + start, words.begin() + end);
+        } else {
+            for (size_t i = start; i < end; ++i) {
+                trie.insert(words[i]);
+            }
         }
         
         auto t_end = high_resolution_clock::now();
@@ -155,7 +430,7 @@ vector<TimeResult> experiment_time(const vector<string>& words, int M = 16) {
         res.time_per_char_ms = time_ms / chars_in_batch;
         
         results.push_back(res);
-        cout << "  Batch " << (batch + 1) << "/" << M << ": " 
+        log << "  Batch " << (batch + 1) << "/" << M << ": " 
              << time_ms << " ms, "
              << res.time_per_char_ms << " ms/char" << endl;
     }
@@ -166,50 +441,81 @@ vector<TimeResult> experiment_time(const vector<string>& words, int M = 16) {
 // Experimento 3: Autocompletado
 /**
  * @brief Simula la escritura palabra a palabra para evaluar autocompletado.
- * @tparam Policy Política de prioridad (FrequencyPolicy o RecentPolicy).
- * @param dict Palabras del diccionario base.
- * @param text Palabras del texto simulado (Wikipedia o aleatorio).
- * @param output Ruta del CSV donde guardar los resultados.
+ * @tparam TrieT Estructura a evaluar (Trie o RadixTrie con su política).
+ * @param for_each_word Recorre el texto llamando a su argumento con cada
+ * palabra (string_view); así el texto puede venir de memoria o del archivo.
+ * Opcionalmente entrega también la ruta ya descendida de la palabra (ver
+ * Trie::descend_batch), que reemplaza las llamadas a descend.
  * @details Reproduce el proceso descrito en el enunciado sección 4.3:
- * descender, autocompletar y actualizar prioridad en cada palabra.
+ * descender, autocompletar y actualizar prioridad en cada palabra. Guarda un
+ * checkpoint en cada potencia de 2 hasta 2^21 y al final del texto. Con
+ * PrefixCache<D> los primeros D prefijos se consultan con lookup_prefix y se
+ * cuentan los que respondió la tabla.
+ * @param log Salida del progreso.
  */
-template<typename Policy>
-vector<AutocompleteResult> experiment_autocomplete(
-    Trie<Policy>& trie, 
-    const vector<string>& text_words) {
+template<typename TrieT, typename ForEachWord>
+vector<AutocompleteResult> replay_autocomplete(TrieT& trie, ForEachWord&& for_each_word,
+                                               ostream& log = cout) {
     
-    cout << "Iniciando experimento de autocompletado con política " 
-         << Policy::name() << "..." << endl;
+    log << "Iniciando experimento de autocompletado con política " 
+         << TrieT::policy_type::name() << "..." << endl;
     
     vector<AutocompleteResult> results;
-    size_t L = text_words.size();
-    
-    // Puntos de medición: 2^0, 2^1, ..., 2^21, L
-    vector<size_t> checkpoints;
-    for (int i = 0; i <= 21; ++i) {
-        size_t cp = 1ULL << i;
-        if (cp <= L) checkpoints.push_back(cp);
-    }
-    if (checkpoints.empty() || checkpoints.back() != L) {
-        checkpoints.push_back(L);
-    }
-    
-    size_t next_checkpoint_idx = 0;
+    size_t count = 0;
     size_t chars_typed = 0;
     size_t total_chars = 0;
+    size_t keystrokes = 0;
+    size_t table_hits = 0;
+    size_t updates = 0;
+    constexpr size_t depth = prefix_cache_depth_v<TrieT>;
+    auto t_start = high_resolution_clock::now();
+
+    auto checkpoint = [&]() {
+        AutocompleteResult res;
+        res.words_processed = count;
+        res.total_chars_in_text = total_chars;
+        res.chars_typed = chars_typed;
+        res.percentage = (total_chars > 0) 
+            ? (100.0 * chars_typed / total_chars) 
+            : 0.0;
+        res.keystrokes = keystrokes;
+        res.updates = updates;
+        res.table_hit_rate = keystrokes ? static_cast<double>(table_hits) / keystrokes : 0.0;
+        res.keystroke_ns = keystrokes
+            ? duration_cast<nanoseconds>(high_resolution_clock::now() - t_start).count()
+                / static_cast<double>(keystrokes)
+            : 0.0;
+        
+        results.push_back(res);
+        log << "  Checkpoint " << count << ": " 
+             << res.percentage << "% caracteres escritos" << endl;
+    };
     
-    for (size_t i = 0; i < L; ++i) {
-        const string& w = text_words[i];
+    using Path = vector<decltype(trie.root())>;
+    for_each_word([&](string_view w, const Path* path = nullptr) {
         total_chars += w.length();
         
         // Simulamos la escritura
-        auto* v = trie.root();
+        auto v = trie.root();
         size_t descends = 0;
         bool found = false;
         
         for (size_t j = 0; j < w.length(); ++j) {
-            v = trie.descend(v, w[j]);
+            // Los prefijos cortos salen de la tabla si el trie la tiene
+            decltype(trie.autocomplete(v)) completion{};
+            bool looked_up = false;
+            if constexpr (depth > 0) {
+                if (!path && j < depth) {
+                    auto m = trie.lookup_prefix(w.substr(0, j + 1));
+                    v = m.node;
+                    completion = m.best;
+                    table_hits += m.from_table;
+                    looked_up = true;
+                }
+            }
+            if (!looked_up) v = path ? (*path)[j] : trie.descend(v, w[j]);
             ++descends;
+            ++keystrokes;
             
             if (!v) {
                 // Palabra no está en el trie
@@ -218,14 +524,12 @@ vector<AutocompleteResult> experiment_autocomplete(
             }
             
             // Intentamos autocompletar
-            auto* completion = trie.autocomplete(v);
-            if (completion && completion->str) {
-                if (*completion->str == w) {
-                    // ¡Autocompletado exitoso!
-                    chars_typed += descends;
-                    found = true;
-                    break;
-                }
+            if (!looked_up) completion = trie.autocomplete(v);
+            if (completion && trie.word(completion) == w) {
+                // ¡Autocompletado exitoso!
+                chars_typed += descends;
+                found = true;
+                break;
             }
         }
         
@@ -236,175 +540,2036 @@ vector<AutocompleteResult> experiment_autocomplete(
         
         // Actualizamos prioridad si la palabra está en el trie
         if (v) {
-            auto* terminal = trie.descend(v, '$');
+            auto terminal = trie.descend(v, '$');
             if (terminal && terminal->is_terminal) {
                 trie.update_priority(terminal);
+                ++updates;
             }
         }
         
-        // Guardamos checkpoint
-        size_t current_count = i + 1;
-        if (next_checkpoint_idx < checkpoints.size() && 
-            current_count == checkpoints[next_checkpoint_idx]) {
-            
-            AutocompleteResult res;
-            res.words_processed = current_count;
-            res.total_chars_in_text = total_chars;
-            res.chars_typed = chars_typed;
-            res.percentage = (total_chars > 0) 
-                ? (100.0 * chars_typed / total_chars) 
-                : 0.0;
-            
-            results.push_back(res);
-            cout << "  Checkpoint " << current_count << ": " 
-                 << res.percentage << "% caracteres escritos" << endl;
-            
-            ++next_checkpoint_idx;
-        }
-    }
+        // Puntos de medición: 2^0, 2^1, ..., 2^21
+        ++count;
+        if ((count & (count - 1)) == 0 && count <= (size_t(1) << 21)) checkpoint();
+    });
+
+    // ... y el total L
+    if (count > 0 && (results.empty() || results.back().words_processed != count)) checkpoint();
     
     return results;
 }
 
-// Guarda resultados de memoria a CSV
-void save_memory_results(const string& filename, 
-                        const vector<MemoryResult>& results) {
-    ofstream file("out/" + filename);
-    file << "words_inserted,chars_inserted,node_count,nodes_per_char\n";
-    for (const auto& r : results) {
-        file << r.words_inserted << "," 
-             << r.chars_inserted << "," 
-             << r.node_count << ","
-             << r.nodes_per_char << "\n";
+// Autocompletado sobre un texto ya cargado en memoria.
+template<typename TrieT>
+vector<AutocompleteResult> experiment_autocomplete(TrieT& trie, const vector<string>& text_words) {
+    return replay_autocomplete(trie, [&](auto&& emit) {
+        for (const auto& w : text_words) emit(w);
+    });
+}
+
+// Autocompletado descendiendo las palabras de a grupos con Trie::descend_batch;
+// la evaluación y las actualizaciones siguen el orden del texto.
+template<typename TrieT>
+vector<AutocompleteResult> experiment_autocomplete_batched(TrieT& trie, const vector<string>& text_words,
+                                                           size_t batch) {
+    vector<vector<typename TrieT::Node*>> paths;
+    return replay_autocomplete(trie, [&](auto&& emit) {
+        for (size_t start = 0; start < text_words.size(); start += batch) {
+            size_t end = min(text_words.size(), start + batch);
+            trie.descend_batch(text_words.begin() + start, text_words.begin() + end, paths);
+            for (size_t i = start; i < end; ++i) emit(text_words[i], &paths[i - start]);
+        }
+    });
+}
+
+// Autocompletado leyendo el texto del archivo por lotes, en memoria constante.
+template<typename TrieT>
+vector<AutocompleteResult> experiment_autocomplete_file(TrieT& trie, const string& filename,
+                                                        ostream& log = cout) {
+    return replay_autocomplete(trie, [&](auto&& emit) {
+        for_each_word_batch(filename, [&](const vector<string_view>& batch) {
+            for (string_view w : batch) emit(w);
+        });
+    }, log);
+}
+
+/**
+ * @brief Mide el costo por carácter de descender y autocompletar cada palabra.
+ * @param found Se suman los prefijos que tuvieron sugerencia.
+ * @return Nanosegundos por carácter.
+ */
+template<typename TrieT>
+double measure_descend_ns(TrieT& trie, const vector<string>& words, size_t& found) {
+    size_t chars = 0;
+    auto t_start = high_resolution_clock::now();
+    for (const auto& w : words) {
+        auto v = trie.root();
+        for (char c : w) {
+            v = trie.descend(v, c);
+            if (!v) break;
+            if (trie.autocomplete(v)) ++found;
+        }
+        chars += w.length();
     }
-    file.close();
-    cout << "Resultados de memoria guardados en " << filename << endl;
+    double query_ns = duration_cast<nanoseconds>(high_resolution_clock::now() - t_start).count();
+    return chars ? query_ns / chars : 0.0;
 }
 
-// Guarda resultados de tiempo a CSV
-void save_time_results(const string& filename, 
-                      const vector<TimeResult>& results) {
-    ofstream file("out/" + filename);
-    file << "words_inserted,chars_in_batch,time_ms,time_per_char_ms\n";
-    for (const auto& r : results) {
-        file << r.words_inserted << "," 
-             << r.chars_in_batch << "," 
-             << r.time_ms << ","
-             << r.time_per_char_ms << "\n";
+// Experimento: comparación de representaciones de nodo
+/**
+ * @brief Compara memoria y rendimiento de una configuración de nodos.
+ * @tparam Options Opciones del Trie (almacenamiento y representación de hijos).
+ * @param layout Nombre de la configuración para el CSV.
+ * @param words Palabras del diccionario base.
+ * @details Mide el tiempo de construcción y el costo por carácter de
+ * descender y autocompletar cada palabra del diccionario.
+ */
+template<typename Policy, typename... Options>
+LayoutResult experiment_layout(const string& layout, const vector<string>& words) {
+    cout << "Iniciando comparación de nodos (" << layout << ")..." << endl;
+
+    Trie<Policy, Options...> trie;
+    auto t_start = high_resolution_clock::now();
+    for (const auto& w : words) {
+        trie.insert(w);
     }
-    file.close();
-    cout << "Resultados de tiempo guardados en " << filename << endl;
+    auto t_end = high_resolution_clock::now();
+    double build_ms = duration_cast<microseconds>(t_end - t_start).count() / 1000.0;
+
+    size_t found = 0;
+
+    LayoutResult res;
+    res.layout = layout;
+    res.node_count = trie.node_count();
+    res.bytes_used = trie.bytes_used();
+    res.build_ms = build_ms;
+    res.descend_ns_per_char = measure_descend_ns(trie, words, found);
+    cout << "  " << res.bytes_used << " bytes, "
+         << res.build_ms << " ms construcción, "
+         << res.descend_ns_per_char << " ns/char (" << found << " autocompletados)" << endl;
+    return res;
 }
 
-// Guarda resultados de autocompletado a CSV
-void save_autocomplete_results(const string& filename, 
-                              const vector<AutocompleteResult>& results) {
-    ofstream file("out/" + filename);
-    file << "words_processed,total_chars,chars_typed,percentage\n";
-    for (const auto& r : results) {
-        file << r.words_processed << "," 
-             << r.total_chars_in_text << "," 
-             << r.chars_typed << ","
-             << r.percentage << "\n";
+/**
+ * @brief Mide el costo promedio de update_priority sobre las palabras de un texto.
+ * @details Primero resuelve los terminales y luego cronometra solo las
+ * actualizaciones, para aislar el costo de propagar hacia la raíz.
+ * @return Nanosegundos por actualización (0 si ninguna palabra está en el trie).
+ */
+template<typename TrieT>
+double measure_update_ns(TrieT& trie, const vector<string>& text_words) {
+    vector<decltype(trie.descend(trie.root(), '$'))> terminals;
+    for (const auto& w : text_words) {
+        auto t = trie.descend(trie.descend_prefix(w), '$');
+        if (t) terminals.push_back(t);
     }
-    file.close();
-    cout << "Resultados de autocompletado guardados en " << filename << endl;
+    if (terminals.empty()) return 0.0;
+
+    auto t_start = high_resolution_clock::now();
+    for (auto& t : terminals) {
+        trie.update_priority(t);
+    }
+    auto t_end = high_resolution_clock::now();
+    return static_cast<double>(duration_cast<nanoseconds>(t_end - t_start).count()) / terminals.size();
 }
 
+// Experimento: Trie vs RadixTrie
 /**
- * @brief Función principal: ejecuta los tres experimentos y genera resultados en /out.
- *
- * - Inserta palabras del diccionario para medir memoria y tiempo.
- * - Construye los Tries (frecuencia y recencia).
- * - Ejecuta la simulación de autocompletado sobre tres datasets:
- *   Wikipedia, random y random_with_distribution.
+ * @brief Compara el Trie con su variante comprimida sobre un texto.
+ * @tparam Policy Política de prioridad.
+ * @param words Palabras del diccionario base.
+ * @param text_words Palabras del texto simulado.
+ * @param dataset Nombre del dataset para el CSV.
+ * @details Construye ambas estructuras desde cero, reproduce la simulación de
+ * tecleo (que debe escribir exactamente los mismos caracteres) y luego mide
+ * update_priority por separado.
  */
-int main() {
-    std::filesystem::create_directories("out");
-    cout << "=== EXPERIMENTACIÓN TRIE ===" << endl;
-    cout << fixed << setprecision(6);
-    
-    // Cargar dataset de palabras
-    cout << "\nCargando words.txt..." << endl;
-    vector<string> words = read_words("datos/words.txt");
+template<typename Policy>
+vector<RadixResult> experiment_radix(const vector<string>& words,
+                                     const vector<string>& text_words,
+                                     const string& dataset) {
+    cout << "Comparando Trie y RadixTrie (" << Policy::name() << ")..." << endl;
 
-    if (words.empty()) {
-        cerr << "Error: no se pudieron cargar las palabras" << endl;
-        return 1;
+    auto run = [&](auto& trie, const string& structure) {
+        for (const auto& w : words) {
+            trie.insert(w);
+        }
+        auto t_start = high_resolution_clock::now();
+        auto replay = experiment_autocomplete(trie, text_words);
+        auto t_end = high_resolution_clock::now();
+
+        RadixResult res;
+        res.structure = structure;
+        res.dataset = dataset;
+        res.node_count = trie.node_count();
+        res.replay_ms = duration_cast<microseconds>(t_end - t_start).count() / 1000.0;
+        res.update_ns = measure_update_ns(trie, text_words);
+        res.chars_typed = replay.empty() ? 0 : replay.back().chars_typed;
+        cout << "  " << structure << ": " << res.node_count << " nodos, "
+             << res.replay_ms << " ms simulación, "
+             << res.update_ns << " ns/update" << endl;
+        return res;
+    };
+
+    Trie<Policy> trie;
+    RadixTrie<Policy> radix;
+    vector<RadixResult> results;
+    results.push_back(run(trie, string("trie_") + Policy::name()));
+    results.push_back(run(radix, string("radix_") + Policy::name()));
+    if (results[0].chars_typed != results[1].chars_typed) {
+        cerr << "Advertencia: RadixTrie escribió " << results[1].chars_typed
+             << " caracteres y Trie " << results[0].chars_typed << endl;
     }
-    cout << "Cargadas " << words.size() << " palabras" << endl;
-    
-    // --- EXPERIMENTO 1: MEMORIA ---
-    cout << "\n=== EXPERIMENTO 1: MEMORIA ===" << endl;
-    auto mem_freq = experiment_memory<FrequencyPolicy>(words);
-    save_memory_results("memory_frequency.csv", mem_freq);
-    
-    // --- EXPERIMENTO 2: TIEMPO ---
-    cout << "\n=== EXPERIMENTO 2: TIEMPO ===" << endl;
-    auto time_freq = experiment_time<FrequencyPolicy>(words);
-    save_time_results("time_frequency.csv", time_freq);
-    
-    // --- EXPERIMENTO 3: AUTOCOMPLETADO ---
-    cout << "\n=== EXPERIMENTO 3: AUTOCOMPLETADO ===" << endl;
-    
-    // Construir trie para frecuencia
-    cout << "\nConstruyendo trie con política de frecuencia..." << endl;
-    Trie<FrequencyPolicy> trie_freq;
+    return results;
+}
+
+// Experimento: alfabetos
+/**
+ * @brief Mide el costo de traducir caracteres y de descender con un alfabeto.
+ * @tparam Alphabet Alfabeto del Trie (CtypeAlphabet es la versión con
+ * isalpha/tolower, para comparar contra la tabla).
+ * @param layout Nombre de las opciones de nodo para el CSV.
+ * @details Primero traduce todos los caracteres del diccionario con
+ * Alphabet::index, sin tocar el trie; luego construye el trie y mide
+ * descend + autocomplete por carácter como experiment_layout.
+ */
+template<typename Policy, typename Alphabet, typename... Options>
+AlphabetResult experiment_alphabet(const string& alphabet, const string& layout, const vector<string>& words) {
+    cout << "Midiendo alfabeto " << alphabet << " (" << layout << ")..." << endl;
+    using TrieT = Trie<Policy, Alphabet, Options...>;
+
+    size_t chars = 0;
+    long checksum = 0;
+    auto t_start = high_resolution_clock::now();
     for (const auto& w : words) {
-        trie_freq.insert(w);
+        for (char c : w) checksum += Alphabet::index(c);
+        chars += w.length();
     }
-    
-    // Construir trie para reciente
-    cout << "Construyendo trie con política reciente..." << endl;
-    Trie<RecentPolicy> trie_recent;
+    double map_ns = duration_cast<nanoseconds>(high_resolution_clock::now() - t_start).count();
+
+    TrieT trie;
+    trie.build_from_sorted(words);
+    size_t found = 0;
+
+    AlphabetResult res;
+    res.alphabet = alphabet;
+    res.layout = layout;
+    res.sigma = TrieT::sigma;
+    res.node_size = sizeof(typename TrieT::Node);
+    res.node_count = trie.node_count();
+    res.bytes_used = trie.bytes_used();
+    res.map_ns_per_char = chars ? map_ns / chars : 0.0;
+    res.descend_ns_per_char = measure_descend_ns(trie, words, found);
+    cout << "  Σ = " << res.sigma << ", " << res.node_size << " bytes/nodo, "
+         << res.map_ns_per_char << " ns/char traducción, "
+         << res.descend_ns_per_char << " ns/char descenso (suma " << checksum << ")" << endl;
+    return res;
+}
+
+// Experimento: Trie vs DoubleArrayTrie
+/**
+ * @brief Compara el trie de punteros con su conversión a arreglo doble.
+ * @tparam Options Opciones del Trie de referencia (p.ej. ArenaStorage).
+ * @param structure Nombre del trie de referencia para el CSV.
+ * @details Construye dos tries iguales desde el diccionario y convierte uno
+ * a DoubleArrayTrie. En ambos mide memoria, costo por carácter de descender
+ * y autocompletar el diccionario, la simulación de tecleo (que debe escribir
+ * los mismos caracteres) y luego update_priority por separado.
+ */
+template<typename Policy, typename... Options>
+vector<DoubleArrayResult> experiment_double_array(const string& structure,
+                                                  const vector<string>& words,
+                                                  const vector<string>& text_words,
+                                                  const string& dataset) {
+    cout << "Comparando " << structure << " y DoubleArrayTrie..." << endl;
+
+    auto run = [&](auto& trie, const string& name, double build_ms) {
+        size_t found = 0;
+        DoubleArrayResult res;
+        res.structure = name;
+        res.dataset = dataset;
+        res.node_count = trie.node_count();
+        res.bytes_used = trie.bytes_used();
+        res.build_ms = build_ms;
+        res.descend_ns_per_char = measure_descend_ns(trie, words, found);
+        auto t_start = high_resolution_clock::now();
+        auto replay = experiment_autocomplete(trie, text_words);
+        res.replay_ms = duration_cast<microseconds>(high_resolution_clock::now() - t_start).count() / 1000.0;
+        res.update_ns = measure_update_ns(trie, text_words);
+        res.chars_typed = replay.empty() ? 0 : replay.back().chars_typed;
+        cout << "  " << name << ": " << res.bytes_used << " bytes, "
+             << res.descend_ns_per_char << " ns/char, "
+             << res.replay_ms << " ms simulación, "
+             << res.update_ns << " ns/update" << endl;
+        return res;
+    };
+
+    vector<DoubleArrayResult> results;
+    {
+        Trie<Policy, Options...> trie;
+        auto t_start = high_resolution_clock::now();
+        trie.build_from_sorted(words);
+        double build_ms = duration_cast<microseconds>(high_resolution_clock::now() - t_start).count() / 1000.0;
+        results.push_back(run(trie, structure, build_ms));
+    }
+    {
+        // El trie de origen se libera antes de medir
+        unique_ptr<DoubleArrayTrie<Policy>> da;
+        double build_ms;
+        {
+            Trie<Policy, Options...> source;
+            source.build_from_sorted(words);
+            auto t_start = high_resolution_clock::now();
+            da = make_unique<DoubleArrayTrie<Policy>>(source);
+            build_ms = duration_cast<microseconds>(high_resolution_clock::now() - t_start).count() / 1000.0;
+        }
+        results.push_back(run(*da, "double_array", build_ms));
+    }
+    if (results[0].chars_typed != results[1].chars_typed) {
+        cerr << "Advertencia: DoubleArrayTrie escribió " << results[1].chars_typed
+             << " caracteres y " << structure << " " << results[0].chars_typed << endl;
+    }
+    return results;
+}
+
+// Experimento: propagación incremental vs recálculo completo
+/**
+ * @brief Cuenta los ancestros visitados por update_priority al reproducir un texto.
+ * @tparam Policy Política monótona; se compara contra FullRecompute<Policy>.
+ * @param words Palabras del diccionario base.
+ * @param text_words Palabras del texto simulado.
+ * @param dataset Nombre del dataset para el CSV.
+ */
+template<typename Policy>
+vector<PropagationResult> experiment_propagation(const vector<string>& words,
+                                                 const vector<string>& text_words,
+                                                 const string& dataset) {
+    cout << "Midiendo propagación de prioridades (" << Policy::name() << ")..." << endl;
+
+    auto run = [&](auto& trie, const string& mode) {
+        for (const auto& w : words) {
+            trie.insert(w);
+        }
+        size_t updates = 0;
+        size_t visited = 0;
+        auto t_start = high_resolution_clock::now();
+        for (const auto& w : text_words) {
+            auto* t = trie.descend(trie.descend_prefix(w), '$');
+            if (!t) continue;
+            visited += trie.update_priority(t);
+            ++updates;
+        }
+        auto t_end = high_resolution_clock::now();
+
+        PropagationResult res;
+        res.policy = Policy::name();
+        res.mode = mode;
+        res.dataset = dataset;
+        res.updates = updates;
+        res.avg_visited = updates ? static_cast<double>(visited) / updates : 0.0;
+        res.update_ns = updates
+            ? static_cast<double>(duration_cast<nanoseconds>(t_end - t_start).count()) / updates
+            : 0.0;
+        cout << "  " << mode << ": " << res.avg_visited << " nodos/update, "
+             << res.update_ns << " ns/update" << endl;
+        return res;
+    };
+
+    Trie<Policy> incremental;
+    Trie<FullRecompute<Policy>> full;
+    return {run(incremental, "incremental"), run(full, "full")};
+}
+
+// Experimento: contadores internos del Trie
+/**
+ * @brief Reproduce un texto sobre Trie<Policy, CollectStats> y resume los
+ * contadores: nodos por descenso, profundidad de la propagación, casilleros
+ * leídos por recompute_best y cambios de best_terminal.
+ * @param words Palabras del diccionario base.
+ * @param text_words Palabras del texto simulado.
+ * @param dataset Nombre del dataset para el CSV.
+ * @param mode "incremental" o "full" (FullRecompute<Policy>).
+ */
+template<typename Policy>
+TrieStatsResult experiment_instrumentation(const vector<string>& words, const vector<string>& text_words,
+                                           const string& dataset, const string& mode) {
+    Trie<Policy, CollectStats> trie;
     for (const auto& w : words) {
-        trie_recent.insert(w);
+        trie.insert(w);
     }
-    
-    // Datasets de texto
-    vector<string> datasets = {
-        "datos/wikipedia.txt", 
-        "datos/random.txt", 
-        "datos/random_with_distribution.txt"
+    trie.reset_stats();
+    size_t updates = 0;
+    for (const auto& w : text_words) {
+        auto* t = trie.descend(trie.descend_prefix(w), '$');
+        if (!t) continue;
+        trie.update_priority(t);
+        ++updates;
+    }
+    const TrieStats& s = trie.stats();
+    auto ratio = [](uint64_t a, uint64_t b) { return b ? static_cast<double>(a) / b : 0.0; };
+
+    TrieStatsResult res;
+    res.policy = Policy::name();
+    res.mode = mode;
+    res.dataset = dataset;
+    res.updates = updates;
+    res.avg_prefix_nodes = ratio(s.prefix_nodes, s.prefix_descents);
+    res.avg_propagation = ratio(s.propagation_nodes, s.propagations);
+    res.max_propagation = s.max_propagation_depth;
+    res.recomputes_per_update = ratio(s.recomputes, updates);
+    res.slots_per_recompute = ratio(s.slots_scanned, s.recomputes);
+    res.best_changes_per_update = ratio(s.best_changes, updates);
+    cout << "  " << res.policy << " (" << mode << "): " << res.avg_prefix_nodes << " nodos/descenso, "
+         << res.avg_propagation << " nodos/propagación (máx " << res.max_propagation << "), "
+         << res.best_changes_per_update << " cambios de best/update" << endl;
+    return res;
+}
+
+/**
+ * @brief Corre una fase entre start() y stop() de los contadores de hardware.
+ * @details Si perf_event_open no está disponible la fila queda con
+ * available = 0 y contadores en cero; el tiempo se mide igual.
+ */
+template<typename F>
+void measure_phase(PerfCounters& perf, const string& phase, vector<PerfPhaseResult>& out, F&& run) {
+    auto t_start = high_resolution_clock::now();
+    perf.start();
+    run();
+    perf.stop();
+    auto t_end = high_resolution_clock::now();
+    out.push_back({phase, perf.available(),
+                   static_cast<double>(duration_cast<microseconds>(t_end - t_start).count()) / 1000.0,
+                   perf.values()});
+}
+
+// Experimento: propagación diferida
+/**
+ * @brief Envuelve un Trie con DeferredPropagation para llamar flush() cada
+ * `every` actualizaciones y medir cuánto cuesta cada flush.
+ * @details Expone lo que usa replay_autocomplete, así la simulación corre
+ * igual que con un Trie normal.
+ */
+template<typename TrieT>
+struct TimedFlush {
+    using policy_type = typename TrieT::policy_type;
+    using Node = typename TrieT::Node;
+
+    TrieT& trie;
+    size_t every;
+    size_t flushes = 0;
+    size_t flushed_nodes = 0;
+    nanoseconds flush_time{0};
+
+    Node* root() const { return trie.root(); }
+    Node* descend(Node* v, char c) const { return trie.descend(v, c); }
+    Node* autocomplete(Node* v) const { return trie.autocomplete(v); }
+    string_view word(const Node* t) const { return trie.word(t); }
+
+    void update_priority(Node* t) {
+        trie.update_priority(t);
+        if (trie.pending_updates() >= every) flush();
+    }
+
+    void flush() {
+        auto t_start = high_resolution_clock::now();
+        flushed_nodes += trie.flush();
+        flush_time += duration_cast<nanoseconds>(high_resolution_clock::now() - t_start);
+        ++flushes;
+    }
+};
+
+/**
+ * @brief Compara la simulación con propagación inmediata contra la diferida
+ * con distintos intervalos de flush.
+ * @param words Diccionario con que se construye cada trie.
+ * @param text_words Texto simulado.
+ * @param intervals Cantidad de actualizaciones entre flush y flush (la
+ * ventana en que las sugerencias pueden estar desactualizadas).
+ */
+template<typename Policy>
+vector<DeferredResult> experiment_deferred(const vector<string>& words, const vector<string>& text_words,
+                                           const string& dataset, const vector<size_t>& intervals) {
+    cout << "Iniciando experimento de propagación diferida (" << dataset << ")..." << endl;
+    vector<DeferredResult> results;
+    auto finish = [&](size_t every, double ms, const vector<AutocompleteResult>& replay,
+                      size_t flushes, double flush_us, double nodes) {
+        double pct = replay.empty() ? 0.0 : replay.back().percentage;
+        // Solo las actualizaciones que ocurrieron: no todas las palabras del texto llegan a una
+        size_t updates = replay.empty() ? 0 : replay.back().updates;
+        results.push_back({dataset, every, ms, ms > 0 ? updates / (ms / 1000.0) : 0.0,
+                           flushes, flush_us, nodes, pct});
+        cout << "  flush cada " << every << ": " << ms << " ms, " << pct << "% escrito" << endl;
     };
-    
-    for (const auto& dataset : datasets) {
-        cout << "\n--- Dataset: " << dataset << " ---" << endl;
-        
-        vector<string> text_words = read_words(dataset);
-        if (text_words.empty()) {
-            cerr << "Error: no se pudo cargar " << dataset << endl;
-            continue;
-        }
-        cout << "Cargadas " << text_words.size() << " palabras de texto" << endl;
-        
-        // Frecuencia
-        auto start_time = high_resolution_clock::now();
-        auto results_freq = experiment_autocomplete(trie_freq, text_words);
-        auto end_time = high_resolution_clock::now();
-        auto duration_freq = duration_cast<milliseconds>(end_time - start_time);
-        
-        string base_name = std::filesystem::path(dataset).stem().string();
 
-        save_autocomplete_results(
-            "autocomplete_frequency_" + base_name + ".csv", 
-            results_freq
-        );
-        cout << "Tiempo total (frecuencia): " << duration_freq.count() << " ms" << endl;
-        
-        // Reciente
-        start_time = high_resolution_clock::now();
-        auto results_recent = experiment_autocomplete(trie_recent, text_words);
-        end_time = high_resolution_clock::now();
-        auto duration_recent = duration_cast<milliseconds>(end_time - start_time);
-        
-        save_autocomplete_results(
-            "autocomplete_recent_" + base_name + ".csv", 
-            results_recent
-        );
-        cout << "Tiempo total (reciente): " << duration_recent.count() << " ms" << endl;
+    {
+        Trie<Policy> trie;
+        trie.build_parallel(words);
+        auto t_start = high_resolution_clock::now();
+        auto replay = experiment_autocomplete(trie, text_words);
+        double ms = duration_cast<microseconds>(high_resolution_clock::now() - t_start).count() / 1000.0;
+        finish(0, ms, replay, 0, 0.0, 0.0);
     }
-    
+    for (size_t every : intervals) {
+        Trie<Policy, DeferredPropagation<>> trie;
+        trie.build_parallel(words);
+        TimedFlush<Trie<Policy, DeferredPropagation<>>> timed{trie, every};
+        auto t_start = high_resolution_clock::now();
+        auto replay = experiment_autocomplete(timed, text_words);
+        timed.flush();
+        double ms = duration_cast<microseconds>(high_resolution_clock::now() - t_start).count() / 1000.0;
+        finish(every, ms, replay, timed.flushes,
+               duration_cast<nanoseconds>(timed.flush_time).count() / 1000.0 / timed.flushes,
+               static_cast<double>(timed.flushed_nodes) / timed.flushes);
+    }
+    return results;
+}
+
+// Experimento: políticas de prioridad
+/**
+ * @brief Simula el texto con una política sobre un trie nuevo.
+ * @param half_life Media vida de FrecencyPolicy, solo para el CSV.
+ */
+template<typename Policy>
+PolicyResult run_policy(const vector<string>& words, const vector<string>& text_words,
+                        const string& dataset, uint32_t half_life) {
+    Trie<Policy> trie;
+    trie.build_parallel(words);
+    auto t_start = high_resolution_clock::now();
+    auto replay = experiment_autocomplete(trie, text_words);
+    double ms = duration_cast<microseconds>(high_resolution_clock::now() - t_start).count() / 1000.0;
+    AutocompleteResult last = replay.empty() ? AutocompleteResult{} : replay.back();
+    return {dataset, Policy::name(), half_life, last.chars_typed, last.percentage,
+            100.0 - last.percentage, ms, trie.renormalizations()};
+}
+
+/**
+ * @brief Compara cuántas teclas ahorran frecuencia, recencia y frecencia con
+ * distintas medias vidas (en accesos) sobre el mismo texto.
+ * @details Con frecencia también se cuenta cuántas veces se adelantó la época.
+ */
+template<uint32_t... HalfLives>
+vector<PolicyResult> experiment_policies(const vector<string>& words, const vector<string>& text_words,
+                                         const string& dataset) {
+    cout << "Comparando políticas de prioridad (" << dataset << ")..." << endl;
+    vector<PolicyResult> results;
+    results.push_back(run_policy<FrequencyPolicy>(words, text_words, dataset, 0));
+    results.push_back(run_policy<RecentPolicy>(words, text_words, dataset, 0));
+    (results.push_back(run_policy<FrecencyPolicy<HalfLives>>(words, text_words, dataset, HalfLives)), ...);
+    for (const auto& r : results) {
+        cout << "  " << r.policy << " (" << r.half_life << "): " << r.saved_percentage
+             << "% de teclas ahorradas" << endl;
+    }
+    return results;
+}
+
+// Experimento: borrado y compactación
+/**
+ * @brief Mide memoria y latencia de consulta tras borrar y reinsertar parte
+ * del diccionario, antes y después de compact().
+ * @param rounds Rondas de churn; en cada una se borra y se reinserta (en otro
+ * orden) una cuarta parte de las palabras, así el conjunto es el mismo.
+ * Después se borra otra cuarta parte sin reinsertarla.
+ * @details Las consultas recorren las palabras vivas en orden, como
+ * experiment_layout. Los nodos reinsertados salen de la lista libre o del
+ * final del almacén, lejos de sus vecinos; compact() los vuelve a dejar en
+ * orden DFS y suelta la lista libre y las palabras repetidas en la arena.
+ */
+template<typename Policy, typename... Options>
+vector<ChurnResult> experiment_churn(const string& storage, const vector<string>& words, int rounds = 4) {
+    cout << "Iniciando experimento de borrado y compactación (" << storage << ")..." << endl;
+    Trie<Policy, Options...> trie;
+    trie.build_from_sorted(words);
+
+    vector<ChurnResult> results;
+    const vector<string>* queries = &words;     // palabras vivas, en orden
+    auto measure = [&](const string& stage, double compact_ms) {
+        size_t found = 0;
+        ChurnResult r{storage, stage, trie.node_count(), trie.free_nodes(), trie.bytes_used(),
+                      trie.string_bytes(), measure_descend_ns(trie, *queries, found), compact_ms};
+        results.push_back(r);
+        cout << "  " << stage << ": " << r.node_bytes << " bytes de nodos, " << r.string_bytes
+             << " bytes de strings, " << r.descend_ns_per_char << " ns/char" << endl;
+    };
+    measure("inicial", 0.0);
+
+    mt19937 rng(42);
+    vector<string> batch;
+    for (int round = 0; round < rounds; ++round) {
+        batch.clear();
+        for (const auto& w : words) {
+            if (rng() % 4 == 0) batch.push_back(w);
+        }
+        for (const auto& w : batch) trie.erase(w);
+        shuffle(batch.begin(), batch.end(), rng);
+        for (const auto& w : batch) trie.insert(w);
+    }
+    measure("churn", 0.0);
+
+    // Al final se borra otra cuarta parte para siempre: sus nodos quedan en la lista libre
+    vector<string> kept;
+    for (const auto& w : words) {
+        if (rng() % 4 == 0) {
+            trie.erase(w);
+        } else {
+            kept.push_back(w);
+        }
+    }
+    queries = &kept;
+    measure("borrado", 0.0);
+
+    auto t_start = high_resolution_clock::now();
+    trie.compact();
+    measure("compactado", duration_cast<microseconds>(high_resolution_clock::now() - t_start).count() / 1000.0);
+    return results;
+}
+
+// Experimento: exportación a DAWG
+/**
+ * @brief Compara un trie con el autómata mínimo que se exporta de él.
+ * @param snapshot Nombre del estado de prioridades para el CSV.
+ * @details Para cada palabra del diccionario se teclea carácter a carácter y
+ * se pregunta si la sugerencia es la palabra completa: el trie con
+ * autocomplete + word, el autómata con completes_to. Ambos deben acertar en
+ * los mismos prefijos.
+ */
+template<typename TrieT>
+vector<DawgResult> experiment_dawg(const string& snapshot, TrieT& trie, const vector<string>& words) {
+    cout << "Exportando DAWG (" << snapshot << ")..." << endl;
+    auto t_start = high_resolution_clock::now();
+    Dawg dawg(trie);
+    double build_ms = duration_cast<microseconds>(high_resolution_clock::now() - t_start).count() / 1000.0;
+
+    size_t chars = 0;
+    for (const auto& w : words) chars += w.length();
+    auto per_char = [&](auto&& type_word) {
+        size_t suggested = 0;
+        auto t0 = high_resolution_clock::now();
+        for (const auto& w : words) suggested += type_word(w);
+        double ns = duration_cast<nanoseconds>(high_resolution_clock::now() - t0).count();
+        return make_pair(chars ? ns / chars : 0.0, suggested);
+    };
+    auto [trie_ns, trie_hits] = per_char([&](const string& w) {
+        size_t hits = 0;
+        auto* v = trie.root();
+        for (char c : w) {
+            if (!(v = trie.descend(v, c))) break;
+            auto* t = trie.autocomplete(v);
+            hits += t && trie.word(t) == w;
+        }
+        return hits;
+    });
+    auto [dawg_ns, dawg_hits] = per_char([&](const string& w) {
+        size_t hits = 0;
+        Dawg::State s = dawg.root();
+        for (size_t i = 0; i < w.size(); ++i) {
+            if ((s = dawg.descend(s, w[i])) == Dawg::none) break;
+            hits += dawg.completes_to(s, string_view(w).substr(i + 1));
+        }
+        return hits;
+    });
+    if (trie_hits != dawg_hits) cerr << "  ¡El DAWG no coincide con el trie!" << endl;
+
+    vector<DawgResult> results = {
+        {snapshot, "trie", trie.node_count(), trie.node_count() - 1, trie.bytes_used(), 0.0, trie_ns, trie_hits},
+        {snapshot, "dawg", dawg.state_count(), dawg.transition_count(), dawg.bytes_used(), build_ms, dawg_ns, dawg_hits},
+    };
+    cout << "  " << trie.node_count() << " nodos -> " << dawg.state_count() << " estados, "
+         << dawg.bytes_used() << " bytes, " << dawg_ns << " ns/char (trie " << trie_ns << ")" << endl;
+    return results;
+}
+
+// Experimento: consultas por lotes con prefetch
+/**
+ * @brief Compara la simulación de tecleo palabra a palabra con la versión que
+ * desciende grupos de palabras intercalando prefetch.
+ * @param words Diccionario con que se construye cada trie.
+ * @param text_words Texto simulado.
+ * @param batches Tamaños de grupo a probar.
+ * @details Cada corrida usa un trie nuevo; todas deben escribir exactamente
+ * los mismos caracteres que la corrida escalar.
+ */
+template<typename Policy>
+vector<BatchResult> experiment_batch(const vector<string>& words, const vector<string>& text_words,
+                                     const string& dataset, const vector<size_t>& batches) {
+    cout << "Iniciando experimento de consultas por lotes (" << dataset << ")..." << endl;
+    vector<BatchResult> results;
+    auto run = [&](const string& mode, size_t batch) {
+        Trie<Policy> trie;
+        trie.build_parallel(words);
+        auto t_start = high_resolution_clock::now();
+        auto replay = batch ? experiment_autocomplete_batched(trie, text_words, batch)
+                            : experiment_autocomplete(trie, text_words);
+        double ms = duration_cast<microseconds>(high_resolution_clock::now() - t_start).count() / 1000.0;
+        size_t typed = replay.empty() ? 0 : replay.back().chars_typed;
+        results.push_back({dataset, mode, batch, typed, ms, ms > 0 ? typed / (ms / 1000.0) : 0.0});
+        if (typed != results.front().chars_typed) {
+            cerr << "Advertencia: " << mode << " con lote " << batch
+                 << " no coincide con la simulación escalar" << endl;
+        }
+    };
+    run("scalar", 0);
+    for (size_t b : batches) run("batched", b);
+    for (const auto& r : results) {
+        cout << "  " << r.mode << " (" << r.batch << "): " << r.lookups_per_s << " teclas/s" << endl;
+    }
+    return results;
+}
+
+// Experimento: tabla de prefijos cortos
+/**
+ * @brief Simula el tecleo consultando cada prefijo con lookup_prefix, con y
+ * sin PrefixCache<D>, y mide cuántas teclas responde la tabla y cuánto tarda.
+ * @tparam Cache NoPrefixCache o PrefixCache<D>.
+ * @param words Diccionario con que se construye el trie.
+ * @param text_words Texto simulado.
+ * @details Cada tecla es una consulta desde la raíz con el prefijo completo,
+ * como la recibiría un servidor. Luego repite solo las consultas de hasta 3
+ * caracteres sobre el trie ya usado, sin actualizar, para aislar el camino
+ * que la tabla reemplaza. Todas las variantes deben escribir los mismos
+ * caracteres.
+ */
+template<typename Policy, typename Cache>
+PrefixCacheResult experiment_prefix_cache(const vector<string>& words, const vector<string>& text_words,
+                                          const string& dataset) {
+    using TrieT = Trie<Policy, Cache>;
+    TrieT trie;
+    trie.build_parallel(words);
+
+    size_t lookups = 0;
+    size_t hits = 0;
+    size_t typed = 0;
+    auto t_start = high_resolution_clock::now();
+    for (const auto& w : text_words) {
+        string_view sv(w);
+        typename TrieT::Node* v = nullptr;
+        size_t j = 1;
+        for (; j <= sv.size(); ++j) {
+            auto m = trie.lookup_prefix(sv.substr(0, j));
+            ++lookups;
+            hits += m.from_table;
+            v = m.node;
+            if (!v || (m.best && trie.word(m.best) == sv)) break;
+        }
+        typed += v && j <= sv.size() ? j : sv.size();
+        if (auto* t = trie.descend(v, '$'); t && t->is_terminal) trie.update_priority(t);
+    }
+    auto t_end = high_resolution_clock::now();
+
+    size_t short_lookups = 0;
+    size_t found = 0;
+    auto s_start = high_resolution_clock::now();
+    for (const auto& w : text_words) {
+        string_view sv(w);
+        for (size_t j = 1; j <= min<size_t>(sv.size(), 3); ++j) {
+            if (trie.lookup_prefix(sv.substr(0, j)).best) ++found;
+            ++short_lookups;
+        }
+    }
+    auto s_end = high_resolution_clock::now();
+
+    PrefixCacheResult res;
+    res.policy = Policy::name();
+    res.dataset = dataset;
+    res.depth = TrieT::prefix_cache_depth;
+    res.lookups = lookups;
+    res.hit_rate = lookups ? static_cast<double>(hits) / lookups : 0.0;
+    res.chars_typed = typed;
+    res.keystroke_ns = lookups
+        ? static_cast<double>(duration_cast<nanoseconds>(t_end - t_start).count()) / lookups
+        : 0.0;
+    res.short_lookup_ns = short_lookups
+        ? static_cast<double>(duration_cast<nanoseconds>(s_end - s_start).count()) / short_lookups
+        : 0.0;
+    res.short_suggested = short_lookups ? static_cast<double>(found) / short_lookups : 0.0;
+    res.table_bytes = trie.prefix_cache_bytes();
+    cout << "  " << res.policy << " D=" << res.depth << ": " << 100.0 * res.hit_rate << "% desde la tabla, "
+         << res.keystroke_ns << " ns/tecla, " << res.short_lookup_ns << " ns/consulta corta" << endl;
+    return res;
+}
+
+// Experimento: velocidad de lectura de palabras
+/**
+ * @brief Mide MB/s de los lectores de palabras sobre cada archivo.
+ * @param files Archivos a leer.
+ * @details Compara ifstream >> word, read_words (lotes de string_view
+ * copiados a un vector<string>) y el recorrido por lotes sin materializar
+ * (for_each_word_batch), que es lo que usa experiment_autocomplete_file.
+ */
+vector<LoaderResult> experiment_loader(const vector<string>& files) {
+    cout << "Iniciando experimento de lectura de palabras..." << endl;
+    vector<LoaderResult> results;
+    for (const auto& f : files) {
+        std::error_code ec;
+        auto bytes = std::filesystem::file_size(f, ec);
+        if (ec) continue;
+        double mb = bytes / (1024.0 * 1024.0);
+        string name = std::filesystem::path(f).stem().string();
+
+        auto measure = [&](const string& method, auto&& load) {
+            auto t_start = high_resolution_clock::now();
+            size_t words = load();
+            double ms = duration_cast<microseconds>(high_resolution_clock::now() - t_start).count() / 1000.0;
+            results.push_back({method, name, words, mb, ms, ms > 0 ? mb / (ms / 1000.0) : 0.0});
+            cout << "  " << name << " / " << method << ": " << results.back().mb_per_s << " MB/s" << endl;
+        };
+        measure("ifstream", [&] { return read_words_ifstream(f).size(); });
+        measure("read_words", [&] { return read_words(f).size(); });
+        measure("stream_batches", [&] {
+            size_t chars = 0;
+            size_t n = for_each_word_batch(f, [&](const vector<string_view>& batch) {
+                for (string_view w : batch) chars += w.size();
+            });
+            return chars > 0 ? n : 0;
+        });
+    }
+    return results;
+}
+
+// Experimento: carga desde snapshot
+/**
+ * @brief Compara arrancar leyendo el diccionario e insertando con abrir un
+ * snapshot mapeado.
+ * @param words_file Diccionario de palabras.
+ * @param snapshot_path Archivo temporal para el snapshot.
+ * @details La primera consulta es descend_prefix + autocomplete de la primera
+ * palabra del diccionario; en el trie mapeado incluye los fallos de página.
+ * El archivo recién escrito suele quedar en la caché de páginas del sistema.
+ */
+template<typename Policy>
+vector<SnapshotResult> experiment_snapshot(const string& words_file, const string& snapshot_path) {
+    cout << "Iniciando experimento de snapshot con política " << Policy::name() << "..." << endl;
+    vector<SnapshotResult> results;
+
+    auto t_start = high_resolution_clock::now();
+    vector<string> words = read_words(words_file);
+    Trie<Policy> trie;
+    for (const auto& w : words) {
+        trie.insert(w);
+    }
+    auto t_loaded = high_resolution_clock::now();
+    trie.autocomplete(trie.descend_prefix(words.front()));
+    auto t_query = high_resolution_clock::now();
+    results.push_back({"read_words+insert",
+                       duration_cast<microseconds>(t_loaded - t_start).count() / 1000.0,
+                       duration_cast<nanoseconds>(t_query - t_loaded).count() / 1000.0,
+                       trie.bytes_used()});
+
+    save_snapshot(trie, snapshot_path);
+
+    t_start = high_resolution_clock::now();
+    MappedTrie<Policy> mapped(snapshot_path);
+    t_loaded = high_resolution_clock::now();
+    auto* completion = mapped.autocomplete(mapped.descend_prefix(words.front()));
+    t_query = high_resolution_clock::now();
+    results.push_back({"mmap_snapshot",
+                       duration_cast<microseconds>(t_loaded - t_start).count() / 1000.0,
+                       duration_cast<nanoseconds>(t_query - t_loaded).count() / 1000.0,
+                       mapped.mapped_bytes()});
+
+    auto expected = trie.autocomplete(trie.descend_prefix(words.front()));
+    if ((completion == nullptr) != (expected == nullptr) ||
+        (completion && mapped.word(completion) != trie.word(expected))) {
+        cerr << "Advertencia: el snapshot no coincide con el trie original" << endl;
+    }
+    for (const auto& r : results) {
+        cout << "  " << r.method << ": carga " << r.load_ms << " ms, primera consulta "
+             << r.first_query_us << " us" << endl;
+    }
+    return results;
+}
+
+// Experimento: construcción paralela
+/**
+ * @brief Mide build_parallel con distintas cantidades de hilos.
+ * @tparam Options Opciones del Trie (almacenamiento, etc.).
+ * @param label Nombre de la configuración para el CSV.
+ * @param words Palabras del diccionario.
+ * @param thread_counts Cantidades de hilos a probar.
+ * @details La referencia es insertar todas las palabras con insert(); la
+ * fila con threads = 0 corresponde a esa referencia.
+ */
+template<typename Policy, typename... Options>
+vector<ParallelBuildResult> experiment_parallel_build(const string& label,
+                                                      const vector<string>& words,
+                                                      const vector<unsigned>& thread_counts) {
+    cout << "Iniciando construcción paralela (" << label << ")..." << endl;
+
+    auto t_start = high_resolution_clock::now();
+    {
+        Trie<Policy, Options...> trie;
+        for (const auto& w : words) {
+            trie.insert(w);
+        }
+    }
+    double base_ms = duration_cast<microseconds>(high_resolution_clock::now() - t_start).count() / 1000.0;
+
+    vector<ParallelBuildResult> results;
+    results.push_back({label, 0, base_ms, 1.0});
+    for (unsigned threads : thread_counts) {
+        t_start = high_resolution_clock::now();
+        {
+            Trie<Policy, Options...> trie;
+            trie.build_parallel(words, threads);
+        }
+        double ms = duration_cast<microseconds>(high_resolution_clock::now() - t_start).count() / 1000.0;
+        results.push_back({label, threads, ms, base_ms / ms});
+        cout << "  " << threads << " hilos: " << ms << " ms (x" << base_ms / ms << ")" << endl;
+    }
+    return results;
+}
+
+// Experimento: lecturas concurrentes con un escritor activo
+/**
+ * @brief Mide el rendimiento de lectores sin bloqueo mientras un escritor
+ * actualiza prioridades.
+ * @tparam Policy Política de prioridad.
+ * @param words Palabras del diccionario (se insertan y luego se consultan).
+ * @param reader_counts Cantidades de hilos lectores a probar.
+ * @param duration Duración de cada corrida.
+ * @details Cada lector desciende carácter a carácter y autocompleta en cada
+ * paso; el escritor llama update_priority en un orden pseudoaleatorio.
+ */
+template<typename Policy>
+vector<ConcurrencyResult> experiment_concurrency(const vector<string>& words,
+                                                 const vector<unsigned>& reader_counts,
+                                                 milliseconds duration) {
+    cout << "Iniciando experimento de concurrencia con política " << Policy::name() << "..." << endl;
+
+    Trie<Policy, ArenaStorage, ThreadSafe> trie;
+    for (const auto& w : words) {
+        trie.insert(w);
+    }
+
+    vector<ConcurrencyResult> results;
+    for (unsigned readers : reader_counts) {
+        atomic<bool> stop{false};
+        atomic<size_t> reads{0};
+        size_t updates = 0;
+
+        vector<thread> pool;
+        for (unsigned r = 0; r < readers; ++r) {
+            pool.emplace_back([&, r]() {
+                size_t local = 0;
+                size_t i = r * (words.size() / readers);
+                while (!stop.load(memory_order_relaxed)) {
+                    const string& w = words[i++ % words.size()];
+                    auto* v = trie.root();
+                    for (char c : w) {
+                        v = trie.descend(v, c);
+                        if (!v) break;
+                        trie.autocomplete(v);
+                        ++local;
+                    }
+                }
+                reads += local;
+            });
+        }
+
+        auto t_start = high_resolution_clock::now();
+        auto deadline = t_start + duration;
+        size_t i = 0;
+        while (high_resolution_clock::now() < deadline) {
+            for (int step = 0; step < 256; ++step) {
+                const string& w = words[(i++ * 7919) % words.size()];
+                trie.update_priority(trie.descend(trie.descend_prefix(w), '$'));
+                ++updates;
+            }
+        }
+        stop = true;
+        for (auto& t : pool) t.join();
+        auto t_end = high_resolution_clock::now();
+
+        ConcurrencyResult res;
+        res.readers = readers;
+        res.duration_ms = duration_cast<microseconds>(t_end - t_start).count() / 1000.0;
+        res.reads_per_s = reads.load() / (res.duration_ms / 1000.0);
+        res.updates_per_s = updates / (res.duration_ms / 1000.0);
+        results.push_back(res);
+        cout << "  " << readers << " lectores: " << res.reads_per_s << " lecturas/s, "
+             << res.updates_per_s << " updates/s" << endl;
+    }
+    return results;
+}
+
+/**
+ * @brief Reproduce un texto desde N hilos, repartiendo las palabras por turno.
+ * @param update Función que registra el uso de una palabra (debe ser thread-safe).
+ * @return Resultado con actualizaciones por segundo.
+ */
+template<typename UpdateFn>
+ShardingResult replay_threads(const string& structure, const vector<string>& text_words,
+                              unsigned threads, UpdateFn update) {
+    atomic<size_t> updates{0};
+    auto t_start = high_resolution_clock::now();
+    vector<thread> pool;
+    for (unsigned tid = 0; tid < threads; ++tid) {
+        pool.emplace_back([&, tid]() {
+            size_t local = 0;
+            for (size_t i = tid; i < text_words.size(); i += threads) {
+                if (update(text_words[i])) ++local;
+            }
+            updates += local;
+        });
+    }
+    for (auto& t : pool) t.join();
+    auto t_end = high_resolution_clock::now();
+
+    ShardingResult res;
+    res.structure = structure;
+    res.threads = threads;
+    res.updates = updates.load();
+    res.time_ms = duration_cast<microseconds>(t_end - t_start).count() / 1000.0;
+    res.updates_per_s = res.updates / (res.time_ms / 1000.0);
+    cout << "  " << structure << ", " << threads << " hilos: "
+         << res.updates_per_s << " updates/s" << endl;
+    return res;
+}
+
+// Experimento: escalabilidad de escritores con shards
+/**
+ * @brief Compara un Trie con un solo candado contra ShardedTrie al reproducir
+ * un texto desde varios hilos.
+ * @tparam Policy Política de prioridad.
+ * @param words Palabras del diccionario base.
+ * @param text_words Palabras del texto reproducido.
+ * @param thread_counts Cantidades de hilos a probar.
+ */
+template<typename Policy>
+vector<ShardingResult> experiment_sharding(const vector<string>& words,
+                                           const vector<string>& text_words,
+                                           const vector<unsigned>& thread_counts) {
+    cout << "Iniciando experimento de shards con política " << Policy::name() << "..." << endl;
+    vector<ShardingResult> results;
+
+    for (unsigned threads : thread_counts) {
+        Trie<Policy, ArenaStorage, ThreadSafe> single;
+        for (const auto& w : words) single.insert(w);
+        results.push_back(replay_threads("single", text_words, threads, [&](const string& w) {
+            auto* t = single.descend(single.descend_prefix(w), '$');
+            if (!t) return false;
+            single.update_priority(t);
+            return true;
+        }));
+
+        ShardedTrie<Policy, ArenaStorage, ThreadSafe> sharded;
+        for (const auto& w : words) sharded.insert(w);
+        results.push_back(replay_threads("sharded", text_words, threads, [&](const string& w) {
+            return sharded.update(w);
+        }));
+    }
+    return results;
+}
+
+/**
+ * @brief Mide el costo de hacer durables las prioridades con PriorityLog.
+ * @details Fase "update": ns por uso sin log, solo el camino del llamador
+ * (log_caller_only: el hilo de fondo no escribe mientras se mide), y con log
+ * sin fdatasync y con fdatasync por grupo (incluye el sync() final; con un
+ * solo núcleo el hilo de fondo le quita tiempo a la reproducción). Fase "recovery": abrir
+ * el log sobre un trie recién construido (restore_priorities en bloque) vs
+ * reaplicar los mismos usos uno por uno con update_priority; y lo mismo
+ * partiendo solo de un checkpoint.
+ */
+template <typename Policy>
+vector<PriorityLogResult> experiment_priority_log(const vector<string>& words,
+                                                  const vector<string>& text_words,
+                                                  const string& dataset) {
+    cout << "Iniciando experimento de log de prioridades con política " << Policy::name() << "..." << endl;
+    using TrieT = Trie<Policy, ArenaStorage>;
+    namespace fs = std::filesystem;
+    const fs::path dir = fs::temp_directory_path() / "trie_priority_log";
+    vector<PriorityLogResult> results;
+
+    auto used_terminals = [&](TrieT& T) {
+        vector<typename TrieT::Node*> terminals;
+        for (const auto& w : text_words) {
+            if (auto* t = T.descend(T.descend_prefix(w), '$')) terminals.push_back(t);
+        }
+        return terminals;
+    };
+    auto row = [&](const string& phase, const string& mode, size_t records, double ms,
+                   PriorityLogStats s = {}, size_t recomputed = 0) {
+        double per_s = ms > 0 ? records / (ms / 1000.0) : 0.0;
+        double ns = records ? ms * 1e6 / records : 0.0;
+        results.push_back({dataset, phase, mode, records, ns, per_s, s.groups, s.bytes, ms, recomputed});
+    };
+
+    // Usos sin log
+    {
+        TrieT T;
+        T.build_from_sorted(words);
+        auto terminals = used_terminals(T);
+        auto start = chrono::high_resolution_clock::now();
+        for (auto* t : terminals) T.update_priority(t);
+        auto end = chrono::high_resolution_clock::now();
+        row("update", "no_log", terminals.size(), chrono::duration<double, milli>(end - start).count());
+    }
+
+    // Solo el camino del llamador: el anillo alcanza para todo el texto y el
+    // hilo de fondo no escribe hasta el sync() final (que no se cronometra)
+    {
+        fs::remove_all(dir);
+        TrieT T;
+        T.build_from_sorted(words);
+        auto terminals = used_terminals(T);
+        PriorityLogOptions options;
+        options.group_records = terminals.size();
+        options.group_interval = chrono::hours(1);
+        options.checkpoint_every = 0;
+        PriorityLog<TrieT> log(T, dir.string(), options);
+        auto start = chrono::high_resolution_clock::now();
+        for (auto* t : terminals) log.update_priority(t);
+        auto end = chrono::high_resolution_clock::now();
+        log.sync();
+        row("update", "log_caller_only", terminals.size(), chrono::duration<double, milli>(end - start).count(),
+            log.stats());
+    }
+
+    // Usos con log, sin y con fdatasync, con el hilo de fondo escribiendo
+    // durante la reproducción; el segundo queda en disco para recuperar
+    size_t logged = 0;
+    for (bool sync : {false, true}) {
+        fs::remove_all(dir);
+        TrieT T;
+        T.build_from_sorted(words);
+        auto terminals = used_terminals(T);
+        PriorityLogOptions options;
+        options.sync = sync;
+        options.checkpoint_every = 0;
+        PriorityLog<TrieT> log(T, dir.string(), options);
+        auto start = chrono::high_resolution_clock::now();
+        for (auto* t : terminals) log.update_priority(t);
+        log.sync();
+        auto end = chrono::high_resolution_clock::now();
+        row("update", sync ? "log_fdatasync" : "log_nosync", terminals.size(),
+            chrono::duration<double, milli>(end - start).count(), log.stats());
+        logged = terminals.size();
+    }
+
+    // Recuperación: el log completo en bloque vs un update_priority por registro
+    {
+        TrieT T;
+        T.build_from_sorted(words);
+        PriorityLog<TrieT> log(T, dir.string());
+        const RecoveryInfo& r = log.recovery();
+        row("recovery", "bulk_log", r.log_records, r.ms, {}, r.recomputed);
+
+        auto start = chrono::high_resolution_clock::now();
+        log.checkpoint();
+        auto end = chrono::high_resolution_clock::now();
+        row("checkpoint", "checkpoint", r.log_records, chrono::duration<double, milli>(end - start).count());
+    }
+    {
+        TrieT T;
+        T.build_from_sorted(words);
+        auto terminals = used_terminals(T);
+        auto start = chrono::high_resolution_clock::now();
+        for (auto* t : terminals) T.update_priority(t);
+        auto end = chrono::high_resolution_clock::now();
+        row("recovery", "per_record", logged, chrono::duration<double, milli>(end - start).count());
+    }
+    {
+        TrieT T;
+        T.build_from_sorted(words);
+        PriorityLog<TrieT> log(T, dir.string());
+        const RecoveryInfo& r = log.recovery();
+        row("recovery", "bulk_checkpoint", r.checkpoint_records, r.ms, {}, r.recomputed);
+    }
+    fs::remove_all(dir);
+    return results;
+}
+
+// Guarda resultados de memoria a CSV
+void save_memory_results(const string& filename,
+                         const vector<MemoryResult>& results, ostream& log = cout) {
+    ofstream file("out/" + filename);
+    file << "words_inserted,chars_inserted,node_count,nodes_per_char,bytes_used,topk_bytes,"
+         << "string_bytes,string_bytes_deque\n";
+    for (const auto& r : results) {
+        file << r.words_inserted << "," 
+             << r.chars_inserted << "," 
+             << r.node_count << ","
+             << r.nodes_per_char << ","
+             << r.bytes_used << ","
+             << r.topk_bytes << ","
+             << r.string_bytes << ","
+             << r.string_bytes_deque << "\n";
+    }
+    file.close();
+    log << "Resultados de memoria guardados en " << filename << endl;
+}
+
+// Guarda resultados de tiempo a CSV
+void save_time_results(const string& filename,
+                       const vector<TimeResult>& results, ostream& log = cout) {
+    ofstream file("out/" + filename);
+    file << "words_inserted,chars_in_batch,time_ms,time_per_char_ms\n";
+    for (const auto& r : results) {
+        file << r.words_inserted << "," 
+             << r.chars_in_batch << "," 
+             << r.time_ms << ","
+             << r.time_per_char_ms << "\n";
+    }
+    file.close();
+    log << "Resultados de tiempo guardados en " << filename << endl;
+}
+
+// Guarda la comparación de representaciones de nodo a CSV
+void save_layout_results(const string& filename,
+                         const vector<LayoutResult>& results) {
+    ofstream file("out/" + filename);
+    file << "layout,node_count,bytes_used,bytes_per_node,build_ms,descend_ns_per_char\n";
+    for (const auto& r : results) {
+        file << r.layout << ","
+             << r.node_count << ","
+             << r.bytes_used << ","
+             << static_cast<double>(r.bytes_used) / r.node_count << ","
+             << r.build_ms << ","
+             << r.descend_ns_per_char << "\n";
+    }
+    file.close();
+    cout << "Comparación de nodos guardada en " << filename << endl;
+}
+
+// Guarda la comparación Trie vs RadixTrie a CSV
+void save_radix_results(const string& filename,
+                        const vector<RadixResult>& results) {
+    ofstream file("out/" + filename);
+    file << "structure,dataset,node_count,replay_ms,update_ns,chars_typed\n";
+    for (const auto& r : results) {
+        file << r.structure << ","
+             << r.dataset << ","
+             << r.node_count << ","
+             << r.replay_ms << ","
+             << r.update_ns << ","
+             << r.chars_typed << "\n";
+    }
+    file.close();
+    cout << "Comparación Trie/RadixTrie guardada en " << filename << endl;
+}
+
+// Guarda la comparación de alfabetos a CSV
+void save_alphabet_results(const string& filename,
+                           const vector<AlphabetResult>& results) {
+    ofstream file("out/" + filename);
+    file << "alphabet,layout,sigma,node_size,node_count,bytes_used,map_ns_per_char,descend_ns_per_char\n";
+    for (const auto& r : results) {
+        file << r.alphabet << ","
+             << r.layout << ","
+             << r.sigma << ","
+             << r.node_size << ","
+             << r.node_count << ","
+             << r.bytes_used << ","
+             << r.map_ns_per_char << ","
+             << r.descend_ns_per_char << "\n";
+    }
+    file.close();
+    cout << "Comparación de alfabetos guardada en " << filename << endl;
+}
+
+// Guarda la comparación Trie/DoubleArrayTrie a CSV
+void save_double_array_results(const string& filename,
+                               const vector<DoubleArrayResult>& results) {
+    ofstream file("out/" + filename);
+    file << "structure,dataset,node_count,bytes_used,build_ms,descend_ns_per_char,replay_ms,update_ns,chars_typed\n";
+    for (const auto& r : results) {
+        file << r.structure << ","
+             << r.dataset << ","
+             << r.node_count << ","
+             << r.bytes_used << ","
+             << r.build_ms << ","
+             << r.descend_ns_per_char << ","
+             << r.replay_ms << ","
+             << r.update_ns << ","
+             << r.chars_typed << "\n";
+    }
+    file.close();
+    cout << "Comparación Trie/DoubleArrayTrie guardada en " << filename << endl;
+}
+
+// Guarda el costo de propagación a CSV
+void save_propagation_results(const string& filename,
+                              const vector<PropagationResult>& results) {
+    ofstream file("out/" + filename);
+    file << "policy,mode,dataset,updates,avg_visited,update_ns\n";
+    for (const auto& r : results) {
+        file << r.policy << ","
+             << r.mode << ","
+             << r.dataset << ","
+             << r.updates << ","
+             << r.avg_visited << ","
+             << r.update_ns << "\n";
+    }
+    file.close();
+    cout << "Costo de propagación guardado en " << filename << endl;
+}
+
+// Guarda los contadores internos del Trie a CSV
+void save_trie_stats_results(const string& filename,
+                             const vector<TrieStatsResult>& results) {
+    ofstream file("out/" + filename);
+    file << "policy,mode,dataset,updates,avg_prefix_nodes,avg_propagation,max_propagation,"
+         << "recomputes_per_update,slots_per_recompute,best_changes_per_update\n";
+    for (const auto& r : results) {
+        file << r.policy << ","
+             << r.mode << ","
+             << r.dataset << ","
+             << r.updates << ","
+             << r.avg_prefix_nodes << ","
+             << r.avg_propagation << ","
+             << r.max_propagation << ","
+             << r.recomputes_per_update << ","
+             << r.slots_per_recompute << ","
+             << r.best_changes_per_update << "\n";
+    }
+    file.close();
+    cout << "Contadores del trie guardados en " << filename << endl;
+}
+
+// Guarda los contadores de hardware por fase a CSV
+void save_perf_results(const string& filename,
+                       const vector<PerfPhaseResult>& results) {
+    ofstream file("out/" + filename);
+    file << "phase,available,ms";
+    for (const char* name : PerfCounters::names) file << "," << name;
+    file << "\n";
+    for (const auto& r : results) {
+        file << r.phase << "," << r.available << "," << r.ms;
+        for (uint64_t v : r.values) file << "," << v;
+        file << "\n";
+    }
+    file.close();
+    cout << "Contadores de hardware guardados en " << filename << endl;
+}
+
+// Guarda resultados de concurrencia a CSV
+void save_concurrency_results(const string& filename,
+                              const vector<ConcurrencyResult>& results) {
+    ofstream file("out/" + filename);
+    file << "readers,duration_ms,reads_per_s,updates_per_s\n";
+    for (const auto& r : results) {
+        file << r.readers << ","
+             << r.duration_ms << ","
+             << r.reads_per_s << ","
+             << r.updates_per_s << "\n";
+    }
+    file.close();
+    cout << "Resultados de concurrencia guardados en " << filename << endl;
+}
+
+// Guarda resultados de propagación diferida a CSV
+void save_deferred_results(const string& filename,
+                           const vector<DeferredResult>& results) {
+    ofstream file("out/" + filename);
+    file << "dataset,flush_every,time_ms,updates_per_s,flushes,flush_us,nodes_per_flush,percentage\n";
+    for (const auto& r : results) {
+        file << r.dataset << ","
+             << r.flush_every << ","
+             << r.time_ms << ","
+             << r.updates_per_s << ","
+             << r.flushes << ","
+             << r.flush_us << ","
+             << r.nodes_per_flush << ","
+             << r.percentage << "\n";
+    }
+    file.close();
+    cout << "Resultados de propagación diferida guardados en " << filename << endl;
+}
+
+// Guarda resultados de borrado y compactación a CSV
+void save_churn_results(const string& filename,
+                        const vector<ChurnResult>& results) {
+    ofstream file("out/" + filename);
+    file << "storage,stage,node_count,free_nodes,node_bytes,string_bytes,descend_ns_per_char,compact_ms\n";
+    for (const auto& r : results) {
+        file << r.storage << ","
+             << r.stage << ","
+             << r.node_count << ","
+             << r.free_nodes << ","
+             << r.node_bytes << ","
+             << r.string_bytes << ","
+             << r.descend_ns_per_char << ","
+             << r.compact_ms << "\n";
+    }
+    file.close();
+    cout << "Resultados de compactación guardados en " << filename << endl;
+}
+
+// Guarda la comparación Trie vs DAWG a CSV
+void save_dawg_results(const string& filename,
+                       const vector<DawgResult>& results) {
+    ofstream file("out/" + filename);
+    file << "snapshot,structure,states,transitions,bytes_used,build_ms,ns_per_char,suggested\n";
+    for (const auto& r : results) {
+        file << r.snapshot << ","
+             << r.structure << ","
+             << r.states << ","
+             << r.transitions << ","
+             << r.bytes_used << ","
+             << r.build_ms << ","
+             << r.ns_per_char << ","
+             << r.suggested << "\n";
+    }
+    file.close();
+    cout << "Comparación con el DAWG guardada en " << filename << endl;
+}
+
+// Guarda la comparación de políticas a CSV
+void save_policy_results(const string& filename,
+                         const vector<PolicyResult>& results) {
+    ofstream file("out/" + filename);
+    file << "dataset,policy,half_life,chars_typed,percentage,saved_percentage,time_ms,renormalizations\n";
+    for (const auto& r : results) {
+        file << r.dataset << ","
+             << r.policy << ","
+             << r.half_life << ","
+             << r.chars_typed << ","
+             << r.percentage << ","
+             << r.saved_percentage << ","
+             << r.time_ms << ","
+             << r.renormalizations << "\n";
+    }
+    file.close();
+    cout << "Comparación de políticas guardada en " << filename << endl;
+}
+
+// Guarda resultados de consultas por lotes a CSV
+void save_batch_results(const string& filename,
+                        const vector<BatchResult>& results) {
+    ofstream file("out/" + filename);
+    file << "dataset,mode,batch,chars_typed,time_ms,lookups_per_s\n";
+    for (const auto& r : results) {
+        file << r.dataset << ","
+             << r.mode << ","
+             << r.batch << ","
+             << r.chars_typed << ","
+             << r.time_ms << ","
+             << r.lookups_per_s << "\n";
+    }
+    file.close();
+    cout << "Resultados de consultas por lotes guardados en " << filename << endl;
+}
+
+// Guarda resultados de la tabla de prefijos a CSV
+void save_prefix_cache_results(const string& filename,
+                               const vector<PrefixCacheResult>& results) {
+    ofstream file("out/" + filename);
+    file << "policy,dataset,depth,lookups,hit_rate,chars_typed,keystroke_ns,short_lookup_ns,"
+         << "short_suggested,table_bytes\n";
+    for (const auto& r : results) {
+        file << r.policy << ","
+             << r.dataset << ","
+             << r.depth << ","
+             << r.lookups << ","
+             << r.hit_rate << ","
+             << r.chars_typed << ","
+             << r.keystroke_ns << ","
+             << r.short_lookup_ns << ","
+             << r.short_suggested << ","
+             << r.table_bytes << "\n";
+    }
+    file.close();
+    cout << "Resultados de la tabla de prefijos guardados en " << filename << endl;
+}
+
+// Guarda resultados de lectura de palabras a CSV
+void save_loader_results(const string& filename,
+                         const vector<LoaderResult>& results) {
+    ofstream file("out/" + filename);
+    file << "method,file,words,megabytes,time_ms,mb_per_s\n";
+    for (const auto& r : results) {
+        file << r.method << ","
+             << r.file << ","
+             << r.words << ","
+             << r.megabytes << ","
+             << r.time_ms << ","
+             << r.mb_per_s << "\n";
+    }
+    file.close();
+    cout << "Resultados de lectura guardados en " << filename << endl;
+}
+
+// Guarda resultados de carga desde snapshot a CSV
+void save_snapshot_results(const string& filename,
+                           const vector<SnapshotResult>& results) {
+    ofstream file("out/" + filename);
+    file << "method,load_ms,first_query_us,bytes\n";
+    for (const auto& r : results) {
+        file << r.method << ","
+             << r.load_ms << ","
+             << r.first_query_us << ","
+             << r.bytes << "\n";
+    }
+    file.close();
+    cout << "Resultados de snapshot guardados en " << filename << endl;
+}
+
+// Guarda resultados de construcción paralela a CSV
+void save_parallel_build_results(const string& filename,
+                                 const vector<ParallelBuildResult>& results) {
+    ofstream file("out/" + filename);
+    file << "storage,threads,time_ms,speedup\n";
+    for (const auto& r : results) {
+        file << r.storage << ","
+             << r.threads << ","
+             << r.time_ms << ","
+             << r.speedup << "\n";
+    }
+    file.close();
+    cout << "Resultados de construcción paralela guardados en " << filename << endl;
+}
+
+// Guarda resultados de escalabilidad con shards a CSV
+void save_sharding_results(const string& filename,
+                           const vector<ShardingResult>& results) {
+    ofstream file("out/" + filename);
+    file << "structure,threads,updates,time_ms,updates_per_s\n";
+    for (const auto& r : results) {
+        file << r.structure << ","
+             << r.threads << ","
+             << r.updates << ","
+             << r.time_ms << ","
+             << r.updates_per_s << "\n";
+    }
+    file.close();
+    cout << "Resultados de shards guardados en " << filename << endl;
+}
+
+void save_priority_log_results(const string& filename,
+                               const vector<PriorityLogResult>& results) {
+    ofstream file("out/" + filename);
+    file << "dataset,phase,mode,records,ns_per_record,records_per_s,groups,bytes,time_ms,recomputed\n";
+    for (const auto& r : results) {
+        file << r.dataset << ","
+             << r.phase << ","
+             << r.mode << ","
+             << r.records << ","
+             << r.ns_per_record << ","
+             << r.records_per_s << ","
+             << r.groups << ","
+             << r.bytes << ","
+             << r.time_ms << ","
+             << r.recomputed << "\n";
+    }
+    file.close();
+    cout << "Resultados del log de prioridades guardados en " << filename << endl;
+}
+
+// Guarda resultados de autocompletado a CSV
+void save_autocomplete_results(const string& filename,
+                               const vector<AutocompleteResult>& results, ostream& log = cout) {
+    ofstream file("out/" + filename);
+    file << "words_processed,total_chars,chars_typed,percentage\n";
+    for (const auto& r : results) {
+        file << r.words_processed << "," 
+             << r.total_chars_in_text << "," 
+             << r.chars_typed << ","
+             << r.percentage << "\n";
+    }
+    file.close();
+    log << "Resultados de autocompletado guardados en " << filename << endl;
+}
+
+// Guarda las teclas, el acierto de la tabla de prefijos y la latencia de la
+// misma simulación. Aparte porque el tiempo cambia de una corrida a otra.
+void save_keystroke_latency_results(const string& filename,
+                                    const vector<AutocompleteResult>& results, ostream& log = cout) {
+    ofstream file("out/" + filename);
+    file << "words_processed,keystrokes,table_hit_rate,keystroke_ns\n";
+    for (const auto& r : results) {
+        file << r.words_processed << ","
+             << r.keystrokes << ","
+             << r.table_hit_rate << ","
+             << r.keystroke_ns << "\n";
+    }
+    file.close();
+    log << "Latencia por tecla guardada en " << filename << endl;
+}
+
+// --- Ejecución de experimentos independientes en paralelo ---
+// Trabajo independiente: escribe sus propios CSV y su progreso en `log`.
+struct Job {
+    string name;
+    function<void(ostream&)> run;
+};
+
+/**
+ * @brief Ejecuta una lista de trabajos independientes en `threads` hilos.
+ * @details Cada trabajo escribe su progreso en un búfer propio que se
+ * imprime entero, en el orden de la lista, apenas terminan él y los
+ * anteriores; así la salida es la misma que en serie. Con threads <= 1
+ * corren uno tras otro escribiendo directo en cout. Si algún trabajo lanza
+ * una excepción, se relanza la primera cuando terminaron todos.
+ */
+void run_jobs(const vector<Job>& jobs, unsigned threads) {
+    if (threads <= 1 || jobs.size() <= 1) {
+        for (const auto& job : jobs) job.run(cout);
+        return;
+    }
+    vector<ostringstream> logs(jobs.size());
+    vector<exception_ptr> errors(jobs.size());
+    vector<bool> done(jobs.size(), false);
+    mutex m;
+    condition_variable finished;
+    atomic<size_t> next{0};
+
+    auto worker = [&] {
+        for (size_t i = next++; i < jobs.size(); i = next++) {
+            logs[i] << fixed << setprecision(6);
+            try {
+                jobs[i].run(logs[i]);
+            } catch (...) {
+                errors[i] = current_exception();
+            }
+            lock_guard<mutex> lock(m);
+            done[i] = true;
+            finished.notify_one();
+        }
+    };
+    vector<thread> pool;
+    for (unsigned t = 0; t < min<size_t>(threads, jobs.size()); ++t) pool.emplace_back(worker);
+
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        unique_lock<mutex> lock(m);
+        finished.wait(lock, [&] { return done[i]; });
+        lock.unlock();
+        cout << logs[i].str() << flush;
+    }
+    for (auto& t : pool) t.join();
+    for (auto& e : errors) {
+        if (e) rethrow_exception(e);
+    }
+}
+
+// Configuración de la corrida, desde la línea de comandos.
+//
+// Uso: experimentos [--experiments memory,time,autocomplete,extra]
+//                   [--datasets wikipedia,random,random_with_distribution]
+//                   [--threads N]
+// Por defecto corre todo en serie. Con --threads N (0 = un hilo por núcleo)
+// los experimentos de memoria, tiempo y autocompletado corren en paralelo;
+// "extra" (el resto de las comparaciones) mide tiempos y corre después, en
+// serie. Los CSV son los mismos que en serie, salvo las columnas de tiempo.
+struct RunConfig {
+    vector<string> experiments = {"memory", "time", "autocomplete", "extra"};
+    vector<string> datasets = {"wikipedia", "random", "random_with_distribution"};
+    unsigned threads = 1;
+
+    bool runs(const string& experiment) const {
+        return find(experiments.begin(), experiments.end(), experiment) != experiments.end();
+    }
+};
+
+void print_usage(ostream& out) {
+    out << "Uso: experimentos [--experiments memory,time,autocomplete,extra]\n"
+           "                  [--datasets wikipedia,random,random_with_distribution]\n"
+           "                  [--threads N]" << endl;
+}
+
+// Separa una lista "a,b,c".
+vector<string> split_list(const string& value) {
+    vector<string> items;
+    size_t start = 0;
+    while (start <= value.size()) {
+        size_t end = value.find(',', start);
+        if (end == string::npos) end = value.size();
+        if (end > start) items.push_back(value.substr(start, end - start));
+        start = end + 1;
+    }
+    return items;
+}
+
+// Lee las opciones; retorna false (con el error en cerr) si alguna no es válida.
+bool parse_args(int argc, char** argv, RunConfig& cfg) {
+    const vector<string> known = cfg.experiments;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (i + 1 >= argc) {
+            cerr << "Falta el valor de " << arg << endl;
+            return false;
+        }
+        string value = argv[++i];
+        if (arg == "--experiments") {
+            cfg.experiments = split_list(value);
+            for (const auto& e : cfg.experiments) {
+                if (find(known.begin(), known.end(), e) == known.end()) {
+                    cerr << "Experimento desconocido: " << e << endl;
+                    return false;
+                }
+            }
+        } else if (arg == "--datasets") {
+            cfg.datasets = split_list(value);
+        } else if (arg == "--threads") {
+            try {
+                cfg.threads = static_cast<unsigned>(stoul(value));
+            } catch (const std::exception&) {
+                cerr << "Número de hilos inválido: " << value << endl;
+                return false;
+            }
+            if (cfg.threads == 0) cfg.threads = max(1u, thread::hardware_concurrency());
+        } else {
+            cerr << "Opción desconocida: " << arg << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Reproduce los textos en orden sobre un mismo trie de una política.
+ * @details Cada texto parte de las prioridades que dejó el anterior, así que
+ * los textos de una política forman un solo trabajo; las dos políticas
+ * corren en paralelo sobre sus propias copias del trie.
+ */
+template<typename TrieT>
+void autocomplete_chain(TrieT& trie, const string& policy, const vector<string>& datasets,
+                        vector<PerfPhaseResult>& perf_results, ostream& log) {
+    PerfCounters perf;      // abierto en el hilo que mide
+    for (const auto& dataset : datasets) {
+        string base_name = std::filesystem::path(dataset).stem().string();
+        log << "\n--- Dataset: " << dataset << " (" << policy << ") ---" << endl;
+        vector<AutocompleteResult> results;
+        auto start_time = high_resolution_clock::now();
+        measure_phase(perf, "autocomplete_" + policy + "_" + base_name, perf_results, [&] {
+            results = experiment_autocomplete_file(trie, dataset, log);
+        });
+        auto duration = duration_cast<milliseconds>(high_resolution_clock::now() - start_time);
+        save_autocomplete_results("autocomplete_" + policy + "_" + base_name + ".csv", results, log);
+        save_keystroke_latency_results("keystroke_latency_" + policy + "_" + base_name + ".csv", results, log);
+        log << "Tiempo total (" << policy << "): " << duration.count() << " ms" << endl;
+    }
+}
+
+/**
+ * @brief Función principal: ejecuta los experimentos y genera resultados en /out.
+ *
+ * - Inserta palabras del diccionario para medir memoria y tiempo.
+ * - Construye el Trie de frecuencia una vez y reproduce los textos sobre
+ *   una copia (Trie::clone); el de recencia se construye en su trabajo.
+ *   Solo se construyen si corre el autocompletado (o "extra", por el DAWG).
+ * - Ejecuta la simulación de autocompletado sobre tres datasets:
+ *   Wikipedia, random y random_with_distribution.
+ * - Memoria, tiempo y autocompletado son trabajos independientes que
+ *   run_jobs reparte en --threads hilos; el resto corre después, en serie.
+ */
+int main(int argc, char** argv) {
+    RunConfig cfg;
+    if (!parse_args(argc, argv, cfg)) {
+        print_usage(cerr);
+        return 1;
+    }
+    std::filesystem::create_directories("out");
+    cout << "=== EXPERIMENTACIÓN TRIE ===" << endl;
+    cout << fixed << setprecision(6);
+    
+    // Cargar dataset de palabras (compartido, solo lectura, por todos los trabajos)
+    cout << "\nCargando words.txt..." << endl;
+    const vector<string> words = read_words("datos/words.txt");
+
+    if (words.empty()) {
+        cerr << "Error: no se pudieron cargar las palabras" << endl;
+        return 1;
+    }
+    cout << "Cargadas " << words.size() << " palabras" << endl;
+
+    // Datasets de texto (los que no están se informan y se omiten)
+    vector<string> datasets;
+    for (const auto& name : cfg.datasets) {
+        string path = "datos/" + name + ".txt";
+        if (!std::filesystem::is_regular_file(path)) {
+            cerr << "Error: no se pudo cargar " << path << endl;
+            continue;
+        }
+        datasets.push_back(path);
+    }
+
+    vector<Job> jobs;
+
+    // --- EXPERIMENTO 1: MEMORIA ---
+    if (cfg.runs("memory")) {
+        auto memory_job = [&](const string& csv, auto experiment) {
+            jobs.push_back({csv, [&words, csv, experiment](ostream& log) {
+                save_memory_results(csv, experiment(words, log), log);
+            }});
+        };
+        jobs.push_back({"memory", [](ostream& log) { log << "\n=== EXPERIMENTO 1: MEMORIA ===" << endl; }});
+        memory_job("memory_frequency.csv", [](const vector<string>& w, ostream& log) {
+            return experiment_memory<FrequencyPolicy>(w, log);
+        });
+        memory_job("memory_frequency_arena.csv", [](const vector<string>& w, ostream& log) {
+            return experiment_memory<FrequencyPolicy, ArenaStorage>(w, log);
+        });
+        memory_job("memory_frequency_sparse.csv", [](const vector<string>& w, ostream& log) {
+            return experiment_memory<FrequencyPolicy, ArenaStorage, SparseLayout>(w, log);
+        });
+        memory_job("memory_frequency_topk.csv", [](const vector<string>& w, ostream& log) {
+            return experiment_memory<FrequencyPolicy, ArenaStorage, SparseLayout, TopK<8>>(w, log);
+        });
+    }
+
+    // --- EXPERIMENTO 2: TIEMPO ---
+    // Carga en bloque vs inserción incremental, ambas sobre la lista ordenada
+    vector<string> sorted_words = words;
+    sort(sorted_words.begin(), sorted_words.end());
+    if (cfg.runs("time")) {
+        jobs.push_back({"time", [](ostream& log) { log << "\n=== EXPERIMENTO 2: TIEMPO ===" << endl; }});
+        jobs.push_back({"time_frequency.csv", [&](ostream& log) {
+            auto results = experiment_time<FrequencyPolicy>(words, 16, false, log);
+            save_time_results("time_frequency.csv", results, log);
+        }});
+        jobs.push_back({"time_frequency_sorted.csv", [&](ostream& log) {
+            auto results = experiment_time<FrequencyPolicy>(sorted_words, 16, false, log);
+            save_time_results("time_frequency_sorted.csv", results, log);
+        }});
+        jobs.push_back({"time_frequency_bulk.csv", [&](ostream& log) {
+            auto results = experiment_time<FrequencyPolicy>(sorted_words, 16, true, log);
+            save_time_results("time_frequency_bulk.csv", results, log);
+        }});
+    }
+
+    // --- EXPERIMENTO 3: AUTOCOMPLETADO ---
+    // El trie de frecuencia se construye una vez: la reproducción usa una
+    // copia y el original sin usar queda para el DAWG de las comparaciones
+    unique_ptr<Trie<FrequencyPolicy>> trie_freq, replay_freq;
+    if (cfg.runs("autocomplete") || cfg.runs("extra")) {
+        cout << "\nConstruyendo trie con política de frecuencia..." << endl;
+        auto build_start = high_resolution_clock::now();
+        trie_freq = make_unique<Trie<FrequencyPolicy>>();
+        trie_freq->build_parallel(words);
+        double build_ms = duration_cast<microseconds>(high_resolution_clock::now() - build_start).count() / 1000.0;
+        cout << "Construcción: " << build_ms << " ms" << endl;
+    }
+
+    vector<PerfPhaseResult> perf_freq, perf_recent, perf_prefix;
+    if (cfg.runs("autocomplete")) {
+        auto clone_start = high_resolution_clock::now();
+        replay_freq.reset(new Trie<FrequencyPolicy>(trie_freq->clone()));
+        double clone_ms = duration_cast<microseconds>(high_resolution_clock::now() - clone_start).count() / 1000.0;
+        cout << "Copia: " << clone_ms << " ms" << endl;
+
+        jobs.push_back({"autocomplete", [](ostream& log) {
+            log << "\n=== EXPERIMENTO 3: AUTOCOMPLETADO ===" << endl;
+        }});
+        jobs.push_back({"autocomplete_frequency", [&](ostream& log) {
+            autocomplete_chain(*replay_freq, "frequency", datasets, perf_freq, log);
+        }});
+        jobs.push_back({"autocomplete_recent", [&](ostream& log) {
+            log << "Construyendo trie con política reciente..." << endl;
+            Trie<RecentPolicy> trie;
+            trie.build_parallel(words);
+            autocomplete_chain(trie, "recent", datasets, perf_recent, log);
+        }});
+        // Frecuencia con tabla de prefijos: mismos caracteres, más tasa de acierto de la tabla
+        jobs.push_back({"autocomplete_frequency_prefix3", [&](ostream& log) {
+            Trie<FrequencyPolicy, PrefixCache<3>> trie;
+            trie.build_parallel(words);
+            autocomplete_chain(trie, "frequency_prefix3", datasets, perf_prefix, log);
+        }});
+    }
+
+    cout << "\nEjecutando " << jobs.size() << " trabajos en " << cfg.threads << " hilo(s)..." << endl;
+    auto jobs_start = high_resolution_clock::now();
+    run_jobs(jobs, cfg.threads);
+    cout << "\nTrabajos terminados en "
+         << duration_cast<milliseconds>(high_resolution_clock::now() - jobs_start).count() << " ms" << endl;
+
+    if (!cfg.runs("extra")) {
+        cout << "\n=== EXPERIMENTACIÓN COMPLETADA ===" << endl;
+        return 0;
+    }
+
+    // --- COMPARACIONES (en serie: miden tiempos) ---
+    cout << "\n=== COMPARACIONES ===" << endl;
+    vector<LayoutResult> layouts;
+    layouts.push_back(experiment_layout<FrequencyPolicy>("dense_heap", words));
+    layouts.push_back(experiment_layout<FrequencyPolicy, ArenaStorage>("dense_arena", words));
+    layouts.push_back(experiment_layout<FrequencyPolicy, SparseLayout>("sparse_heap", words));
+    layouts.push_back(experiment_layout<FrequencyPolicy, ArenaStorage, SparseLayout>("sparse_arena", words));
+    save_layout_results("layout_comparison.csv", layouts);
+
+    // Diccionario que cambia: memoria y latencia antes y después de compactar
+    auto churn = experiment_churn<FrequencyPolicy>("heap", words);
+    auto churn_arena = experiment_churn<FrequencyPolicy, ArenaStorage>("arena", words);
+    auto churn_sparse = experiment_churn<FrequencyPolicy, ArenaStorage, SparseLayout>("sparse_arena", words);
+    churn.insert(churn.end(), churn_arena.begin(), churn_arena.end());
+    churn.insert(churn.end(), churn_sparse.begin(), churn_sparse.end());
+    save_churn_results("churn_compaction.csv", churn);
+
+    // Tabla constexpr vs isalpha/tolower, y el tamaño de nodo de cada alfabeto
+    vector<AlphabetResult> alphabets;
+    alphabets.push_back(experiment_alphabet<FrequencyPolicy, CtypeAlphabet, ArenaStorage>(
+        "ctype", "dense_arena", words));
+    alphabets.push_back(experiment_alphabet<FrequencyPolicy, LowercaseAlphabet, ArenaStorage>(
+        "lowercase", "dense_arena", words));
+    alphabets.push_back(experiment_alphabet<FrequencyPolicy, AlphanumericAlphabet, ArenaStorage>(
+        "alphanumeric", "dense_arena", words));
+    alphabets.push_back(experiment_alphabet<FrequencyPolicy, Utf8ByteAlphabet, ArenaStorage>(
+        "utf8_bytes", "dense_arena", words));
+    alphabets.push_back(experiment_alphabet<FrequencyPolicy, CtypeAlphabet, ArenaStorage, SparseLayout>(
+        "ctype", "sparse_arena", words));
+    alphabets.push_back(experiment_alphabet<FrequencyPolicy, LowercaseAlphabet, ArenaStorage, SparseLayout>(
+        "lowercase", "sparse_arena", words));
+    alphabets.push_back(experiment_alphabet<FrequencyPolicy, Utf8ByteAlphabet, ArenaStorage, SparseLayout>(
+        "utf8_bytes", "sparse_arena", words));
+    save_alphabet_results("alphabet_comparison.csv", alphabets);
+    
+    // Curva de speedup de la construcción paralela (threads = 0: insert())
+    auto par_heap = experiment_parallel_build<FrequencyPolicy>("heap", words, {1, 2, 4, 8});
+    auto par_arena = experiment_parallel_build<FrequencyPolicy, ArenaStorage>("arena", words, {1, 2, 4, 8});
+    par_heap.insert(par_heap.end(), par_arena.begin(), par_arena.end());
+    save_parallel_build_results("parallel_build.csv", par_heap);
+
+    // Arranque: diccionario + insert vs snapshot mapeado
+    string snapshot_path = (std::filesystem::temp_directory_path() / "trie_frequency.snap").string();
+    auto snap = experiment_snapshot<FrequencyPolicy>("datos/words.txt", snapshot_path);
+    std::filesystem::remove(snapshot_path);
+    save_snapshot_results("snapshot_load.csv", snap);
+
+    // --- CONCURRENCIA: lectores sin bloqueo ---
+    cout << "\n=== EXPERIMENTO: CONCURRENCIA ===" << endl;
+    auto conc = experiment_concurrency<FrequencyPolicy>(words, {1, 2, 4, 8}, milliseconds(300));
+    save_concurrency_results("concurrency_frequency.csv", conc);
+    
+    // Velocidad de los lectores de palabras
+    vector<string> loader_files = {"datos/words.txt"};
+    loader_files.insert(loader_files.end(), datasets.begin(), datasets.end());
+    save_loader_results("loader_throughput.csv", experiment_loader(loader_files));
+    
+    vector<RadixResult> radix_results;
+    vector<DoubleArrayResult> double_array_results;
+    vector<PropagationResult> propagation_results;
+    vector<BatchResult> batch_results;
+    vector<DeferredResult> deferred_results;
+    vector<PolicyResult> policy_results;
+    vector<TrieStatsResult> stats_results;
+    vector<PrefixCacheResult> prefix_cache_results;
+    PerfCounters perf;
+    // Primero las fases de autocompletado, medidas dentro de sus trabajos
+    vector<PerfPhaseResult> perf_results = perf_freq;
+    perf_results.insert(perf_results.end(), perf_recent.begin(), perf_recent.end());
+    perf_results.insert(perf_results.end(), perf_prefix.begin(), perf_prefix.end());
+    if (!perf.available()) cout << "perf_event_open no disponible: solo se mide el tiempo por fase" << endl;
+    for (const auto& dataset : datasets) {
+        cout << "\n--- Dataset: " << dataset << " ---" << endl;
+        
+        vector<string> text_words = read_words(dataset);
+        if (text_words.empty()) {
+            cerr << "Error: no se pudo cargar " << dataset << endl;
+            continue;
+        }
+        cout << "Cargadas " << text_words.size() << " palabras de texto" << endl;
+        
+        string base_name = std::filesystem::path(dataset).stem().string();
+
+        // Prefijos cortos desde la tabla: aciertos y latencia por profundidad
+        cout << "Midiendo tabla de prefijos cortos..." << endl;
+        size_t typed_without_cache = 0;
+        auto add_prefix_cache = [&](const PrefixCacheResult& r) {
+            if (r.depth == 0) {
+                typed_without_cache = r.chars_typed;
+            } else if (r.chars_typed != typed_without_cache) {
+                cerr << "Advertencia: la tabla de prefijos cambió los caracteres escritos" << endl;
+            }
+            prefix_cache_results.push_back(r);
+        };
+        add_prefix_cache(
+            experiment_prefix_cache<FrequencyPolicy, NoPrefixCache>(words, text_words, base_name));
+        add_prefix_cache(
+            experiment_prefix_cache<FrequencyPolicy, PrefixCache<1>>(words, text_words, base_name));
+        add_prefix_cache(
+            experiment_prefix_cache<FrequencyPolicy, PrefixCache<2>>(words, text_words, base_name));
+        add_prefix_cache(
+            experiment_prefix_cache<FrequencyPolicy, PrefixCache<3>>(words, text_words, base_name));
+        add_prefix_cache(
+            experiment_prefix_cache<RecentPolicy, NoPrefixCache>(words, text_words, base_name));
+        add_prefix_cache(
+            experiment_prefix_cache<RecentPolicy, PrefixCache<3>>(words, text_words, base_name));
+
+        // Variante comprimida (RadixTrie) sobre tries nuevos
+        for (auto& r : experiment_radix<FrequencyPolicy>(words, text_words, base_name)) {
+            radix_results.push_back(r);
+        }
+        for (auto& r : experiment_radix<RecentPolicy>(words, text_words, base_name)) {
+            radix_results.push_back(r);
+        }
+
+        // Arreglo doble (BASE/CHECK) contra el trie de punteros y el de arena
+        for (auto& r : experiment_double_array<FrequencyPolicy>("trie_heap", words, text_words, base_name)) {
+            double_array_results.push_back(r);
+        }
+        for (auto& r : experiment_double_array<FrequencyPolicy, ArenaStorage>("trie_arena", words, text_words,
+                                                                               base_name)) {
+            double_array_results.push_back(r);
+        }
+
+        // Descensos por lotes con prefetch
+        for (auto& r : experiment_batch<FrequencyPolicy>(words, text_words, base_name, {8, 32, 128})) {
+            batch_results.push_back(r);
+        }
+
+        // Propagación diferida: throughput vs sugerencias desactualizadas
+        for (auto& r : experiment_deferred<FrequencyPolicy>(words, text_words, base_name, {16, 256, 4096})) {
+            deferred_results.push_back(r);
+        }
+
+        // Teclas ahorradas: frecuencia, recencia y frecencia con decaimiento
+        for (auto& r : experiment_policies<4, 1024, 131072>(words, text_words, base_name)) {
+            policy_results.push_back(r);
+        }
+
+        // Ancestros visitados por actualización
+        for (auto& r : experiment_propagation<FrequencyPolicy>(words, text_words, base_name)) {
+            propagation_results.push_back(r);
+        }
+        for (auto& r : experiment_propagation<RecentPolicy>(words, text_words, base_name)) {
+            propagation_results.push_back(r);
+        }
+
+        // Contadores internos (CollectStats) y de hardware de la misma reproducción
+        cout << "Contando trabajo interno del trie..." << endl;
+        measure_phase(perf, "instrumented_frequency_" + base_name, perf_results, [&] {
+            stats_results.push_back(
+                experiment_instrumentation<FrequencyPolicy>(words, text_words, base_name, "incremental"));
+        });
+        measure_phase(perf, "instrumented_recent_" + base_name, perf_results, [&] {
+            stats_results.push_back(
+                experiment_instrumentation<RecentPolicy>(words, text_words, base_name, "incremental"));
+        });
+        measure_phase(perf, "instrumented_full_recompute_" + base_name, perf_results, [&] {
+            using Full = FullRecompute<FrequencyPolicy>;
+            stats_results.push_back(experiment_instrumentation<Full>(words, text_words, base_name, "full"));
+        });
+
+        // Escritores concurrentes: un candado global vs shards por letra
+        if (base_name == "wikipedia") {
+            auto sharding = experiment_sharding<RecentPolicy>(words, text_words, {1, 2, 4, 8});
+            save_sharding_results("sharding_recent_wikipedia.csv", sharding);
+
+            // Durabilidad: log con group commit, checkpoint y recuperación
+            auto priority_log = experiment_priority_log<FrequencyPolicy>(words, text_words, base_name);
+            save_priority_log_results("priority_log_wikipedia.csv", priority_log);
+        }
+    }
+    save_radix_results("radix_comparison.csv", radix_results);
+    save_double_array_results("double_array.csv", double_array_results);
+    save_propagation_results("propagation.csv", propagation_results);
+    save_batch_results("batch_queries.csv", batch_results);
+    save_deferred_results("deferred_propagation.csv", deferred_results);
+    save_policy_results("policy_comparison.csv", policy_results);
+    save_trie_stats_results("trie_stats.csv", stats_results);
+    save_prefix_cache_results("prefix_cache.csv", prefix_cache_results);
+    save_perf_results("perf_counters.csv", perf_results);
+
+    // Autómata mínimo para servir prefijos: sin prioridades y con las que
+    // dejó la simulación de frecuencia
+    {
+        auto dawg = experiment_dawg("sin_uso", *trie_freq, words);
+        if (replay_freq) {
+            auto used = experiment_dawg("frecuencia", *replay_freq, words);
+            dawg.insert(dawg.end(), used.begin(), used.end());
+        }
+        save_dawg_results("dawg_comparison.csv", dawg);
+    }
+    
     cout << "\n=== EXPERIMENTACIÓN COMPLETADA ===" << endl;
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,113 @@
+#include "trie.hpp"
+#include <cassert>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+// Las tablas se evalúan en compilación
+static_assert(LowercaseAlphabet::size == 27 && LowercaseAlphabet::index('$') == 26);
+static_assert(LowercaseAlphabet::index('Q') == LowercaseAlphabet::index('q'));
+static_assert(LowercaseAlphabet::index('7') == -1 && AlphanumericAlphabet::index('7') == 33);
+static_assert(Utf8ByteAlphabet::size == 165 && Utf8ByteAlphabet::index('\xc3') >= 36);
+static_assert(Utf8ByteAlphabet::end_index == Utf8ByteAlphabet::size - 1);
+
+// El tamaño del nodo sigue al alfabeto
+static_assert(sizeof(Trie<FrequencyPolicy, AlphanumericAlphabet>::Node) >
+              sizeof(Trie<FrequencyPolicy>::Node) + 9 * sizeof(void*));
+static_assert(sizeof(Trie<FrequencyPolicy, SparseLayout, Utf8ByteAlphabet>::Node) ==
+              sizeof(Trie<FrequencyPolicy, SparseLayout>::Node) + 16);
+
+template <typename Alphabet>
+void check_symbols() {
+    for (int i = 0; i < static_cast<int>(Alphabet::size); ++i) assert(Alphabet::index(Alphabet::symbol(i)) == i);
+    assert(Alphabet::symbol(Alphabet::end_index) == Alphabet::end_symbol);
+}
+
+// Mismas sugerencias con hijos densos y dispersos, contra el máximo por prefijo
+// (los símbolos van en forma canónica para que no se fundan palabras).
+template <typename TrieT>
+void check_random(const std::string& symbols, const char* label) {
+    std::mt19937 rng(3);
+    std::vector<std::string> words;
+    for (int i = 0; i < 2000; ++i) {
+        std::string w(1 + rng() % 5, ' ');
+        for (char& c : w) c = symbols[rng() % symbols.size()];
+        words.push_back(w);
+    }
+    TrieT T;
+    std::map<std::string, uint64_t> count;
+    for (const auto& w : words) {
+        T.insert(w);
+        count.emplace(w, 0);
+    }
+    for (int i = 0; i < 6000; ++i) {
+        const auto& w = words[std::min(rng() % words.size(), rng() % words.size())];
+        T.update_priority(T.descend(T.descend_prefix(w), '$'));
+        ++count[w];
+    }
+    for (const auto& w : words) {
+        for (size_t len = 0; len <= w.size(); ++len) {
+            std::string pref = w.substr(0, len);
+            uint64_t best = 0;
+            for (const auto& [u, p] : count) {
+                if (u.compare(0, len, pref) == 0) best = std::max(best, p);
+            }
+            auto [t, p] = T.autocomplete_with_priority(T.descend_prefix(pref));
+            assert(p == best && (best == 0 || T.word(t).substr(0, len) == pref));
+        }
+    }
+    std::cout << "[OK] Paridad con el máximo por prefijo (" << label << ")\n";
+}
+
+int main() {
+    {
+        check_symbols<LowercaseAlphabet>();
+        check_symbols<AlphanumericAlphabet>();
+        check_symbols<Utf8ByteAlphabet>();
+        // En el locale "C" la tabla es exactamente isalpha/tolower
+        for (int b = 0; b < 256; ++b) {
+            char c = static_cast<char>(b);
+            assert(LowercaseAlphabet::index(c) == CtypeAlphabet::index(c));
+        }
+        std::cout << "[OK] Tablas\n";
+    }
+
+    {
+        // Con letras solamente los dígitos se pierden y las palabras se funden
+        Trie<FrequencyPolicy> letters;
+        Trie<FrequencyPolicy, AlphanumericAlphabet> alnum;
+        for (const char* w : {"route66", "route", "R2D2"}) {
+            letters.insert(w);
+            alnum.insert(w);
+        }
+        assert(letters.descend(letters.descend_prefix("route"), '$')->is_terminal);
+        assert(!alnum.descend_prefix("route6x") && alnum.descend_prefix("ROUTE6"));
+        assert(alnum.descend(alnum.descend_prefix("r2d2"), '$'));
+        assert(!alnum.descend(alnum.descend_prefix("rd"), '$'));
+        alnum.update_priority(alnum.descend(alnum.descend_prefix("route66"), '$'));
+        assert(alnum.word(alnum.autocomplete(alnum.descend_prefix("rou"))) == "route66");
+
+        // UTF-8 byte a byte: "canción" y "cancion" son palabras distintas
+        Trie<FrequencyPolicy, SparseLayout, Utf8ByteAlphabet> utf8;
+        utf8.insert("canción");
+        utf8.insert("cancion");
+        utf8.insert("año");
+        assert(utf8.node_count() == 1 + 8 + 1 + 2 + 1 + 4 + 1);
+        utf8.update_priority(utf8.descend(utf8.descend_prefix("canción"), '$'));
+        assert(utf8.word(utf8.autocomplete(utf8.descend_prefix("canc"))) == "canción");
+        assert(utf8.descend_prefix("a\xc3") && !utf8.descend_prefix("an"));
+        std::cout << "[OK] Dígitos y UTF-8\n";
+    }
+
+    const std::string alnum = "ab09";
+    const std::string utf8 = "a\xc3\xb1\xc3\xa9" "b\xe2\x82\xac";
+    check_random<Trie<FrequencyPolicy, AlphanumericAlphabet>>(alnum, "alfanumérico denso");
+    using SparseAlnum = Trie<FrequencyPolicy, ArenaStorage, SparseLayout, AlphanumericAlphabet>;
+    check_random<SparseAlnum>(alnum, "alfanumérico disperso");
+    check_random<Trie<FrequencyPolicy, Utf8ByteAlphabet>>(utf8, "UTF-8 denso");
+    check_random<Trie<FrequencyPolicy, SparseLayout, TopK<2>, Utf8ByteAlphabet>>(utf8, "UTF-8 disperso + TopK");
+    check_random<Trie<FrequencyPolicy, CtypeAlphabet>>("abc", "ctype");
+    std::cout << "Alphabet OK\n";
+}
@@ -0,0 +1,139 @@
+#include "trie.hpp"
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+using ArenaTrie = Trie<FrequencyPolicy, ArenaStorage>;
+using HeapTrie = Trie<FrequencyPolicy>;
+
+// Enlaces de 32 bits: el arreglo de hijos ocupa la mitad que con punteros
+static_assert(std::is_same_v<ArenaTrie::Link, uint32_t>);
+static_assert(sizeof(ArenaTrie::Node) < sizeof(HeapTrie::Node));
+
+struct Cell {
+    int value = 0;
+};
+
+int main() {
+    using Store = ArenaNodeStore<Cell>;
+    constexpr size_t slab = Store::slab_size;
+    static_assert(slab == 4096);
+
+    {
+        Store store;
+        assert(!store.get(0) && store.bytes_used() == slab * sizeof(Cell));
+
+        // Índices consecutivos desde 1 (0 es el enlace nulo), contiguos dentro de un bloque
+        uint32_t first = store.create();
+        assert(first == 1);
+        Cell* p = store.get(first);
+        p->value = 7;
+        std::vector<uint32_t> links = {first};
+        for (size_t i = 1; i < 3 * slab; ++i) links.push_back(store.create());
+        for (size_t i = 0; i < links.size(); ++i) assert(links[i] == i + 1);
+        assert(store.get(2) == store.get(1) + 1 && store.get(slab - 1) == store.get(1) + slab - 2);
+        std::cout << "[OK] Enlaces de 32 bits consecutivos\n";
+
+        // Crecer por bloques no mueve los nodos ya entregados
+        assert(store.bytes_used() == 4 * slab * sizeof(Cell));
+        assert(store.get(first) == p && p->value == 7);
+        for (uint32_t l : links) store.get(l)->value = static_cast<int>(l);
+        for (uint32_t l : links) assert(store.get(l)->value == static_cast<int>(l));
+        std::cout << "[OK] Bloques de " << slab << " nodos sin mover los anteriores\n";
+
+        // destroy deja el nodo como nuevo en la lista libre y create lo reutiliza
+        size_t bytes = store.bytes_used();
+        store.destroy(links[10]);
+        store.destroy(links[slab + 3]);
+        assert(store.free_count() == 2 && store.get(links[10])->value == 0);
+        assert(store.create() == links[slab + 3] && store.create() == links[10]);
+        assert(store.free_count() == 0 && store.bytes_used() == bytes);
+        assert(store.create() == 3 * slab + 1);
+        std::cout << "[OK] Lista libre\n";
+
+        // Cada Local llena sus propios bloques
+        std::set<uint32_t> seen(links.begin(), links.end());
+        seen.insert(3 * slab + 1);
+        auto a = store.local();
+        auto b = store.local();
+        for (size_t i = 0; i < slab + 5; ++i) {
+            assert(seen.insert(a.create()).second);
+            assert(seen.insert(b.create()).second);
+        }
+        assert(store.bytes_used() == 8 * slab * sizeof(Cell));
+
+        // clear vuelve a un solo bloque vacío
+        store.clear(first);
+        assert(store.bytes_used() == slab * sizeof(Cell) && store.free_count() == 0);
+        assert(store.create() == 1 && store.get(1)->value == 0);
+
+        // release (lo que usa ~Trie) suelta los bloques sin pedir uno nuevo; si
+        // se vuelve a usar, el primer create() lo pide y sigue sin dar el 0
+        store.release(1);
+        assert(store.bytes_used() == 0);
+        assert(store.create() == 1 && store.bytes_used() == slab * sizeof(Cell));
+        store.release(1);
+        auto c = store.local();
+        assert(c.create() == 1 && store.bytes_used() == slab * sizeof(Cell));
+        std::cout << "[OK] Asignadores por hilo, clear y release\n";
+    }
+
+    {
+        // Un trie en arena responde igual que en heap, también al borrar y reinsertar
+        std::mt19937 rng(5);
+        std::vector<std::string> words;
+        for (int i = 0; i < 4000; ++i) {
+            std::string w(2 + rng() % 7, ' ');
+            for (char& c : w) c = "abcdefghij"[rng() % 10];
+            words.push_back(w);
+        }
+        ArenaTrie arena;
+        HeapTrie heap;
+        for (const auto& w : words) {
+            arena.insert(w);
+            heap.insert(w);
+        }
+        assert(arena.node_count() == heap.node_count() && arena.node_count() > 2 * slab);
+        assert(arena.bytes_used() >= arena.node_count() * sizeof(ArenaTrie::Node));
+
+        auto same = [&] {
+            for (size_t i = 0; i < words.size(); ++i) {
+                const auto& w = words[i];
+                for (size_t len = 0; len <= w.size(); ++len) {
+                    auto* sa = arena.autocomplete(arena.descend_prefix(w.substr(0, len)));
+                    auto* sh = heap.autocomplete(heap.descend_prefix(w.substr(0, len)));
+                    if ((!sa) != (!sh) || (sa && arena.word(sa) != heap.word(sh))) return false;
+                }
+            }
+            return true;
+        };
+        for (int i = 0; i < 20000; ++i) {
+            const auto& w = words[std::min(rng() % words.size(), rng() % words.size())];
+            if (auto* t = arena.descend(arena.descend_prefix(w), '$')) arena.update_priority(t);
+            if (auto* t = heap.descend(heap.descend_prefix(w), '$')) heap.update_priority(t);
+        }
+        assert(same());
+
+        for (size_t i = 0; i < words.size(); i += 3) {
+            arena.erase(words[i]);
+            heap.erase(words[i]);
+        }
+        size_t freed = arena.free_nodes();
+        size_t bytes = arena.bytes_used();
+        assert(freed > 0 && freed == heap.free_nodes());
+        assert(same());
+
+        // Reinsertar toma los nodos de la lista libre antes de pedir bloques
+        for (size_t i = 0; i < words.size(); i += 3) {
+            arena.insert(words[i]);
+            heap.insert(words[i]);
+        }
+        assert(arena.free_nodes() == 0 && arena.bytes_used() == bytes);
+        assert(same());
+        std::cout << "[OK] Trie en arena igual al de heap\n";
+    }
+    std::cout << "Arena storage OK\n";
+}
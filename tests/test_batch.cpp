@@ -0,0 +1,53 @@
+#include "trie.hpp"
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// descend_batch debe dar, para cada palabra, los mismos nodos que descend()
+// carácter a carácter, con cualquier tamaño de grupo.
+template <typename Policy, typename... Options>
+void check_batch() {
+    std::vector<std::string> dict = {"a", "an", "and", "ant", "bat", "bath", "batch", "be", "bee", "cab"};
+    Trie<Policy, Options...> T;
+    for (const auto& w : dict) T.insert(w);
+
+    std::mt19937 rng(5);
+    const std::string alphabet = "abcdehnt$-A";
+    std::vector<std::string> text = {"", "$", "zzz"};
+    for (int i = 0; i < 500; ++i) {
+        std::string w;
+        size_t len = rng() % 7;
+        for (size_t j = 0; j < len; ++j) w.push_back(alphabet[rng() % alphabet.size()]);
+        text.push_back(w);
+    }
+    text.insert(text.end(), dict.begin(), dict.end());
+
+    std::vector<std::vector<typename Trie<Policy, Options...>::Node*>> paths;
+    for (size_t batch : {1, 3, 16, 1000}) {
+        for (size_t start = 0; start < text.size(); start += batch) {
+            size_t end = std::min(text.size(), start + batch);
+            T.descend_batch(text.begin() + start, text.begin() + end, paths);
+            assert(paths.size() == end - start);
+            for (size_t i = start; i < end; ++i) {
+                const auto& path = paths[i - start];
+                auto* v = T.root();
+                size_t j = 0;
+                for (; j < text[i].size(); ++j) {
+                    v = T.descend(v, text[i][j]);
+                    assert(j < path.size() && path[j] == v);
+                    if (!v) break;
+                }
+                assert(path.size() == (v ? j : j + 1));
+            }
+        }
+    }
+    std::cout << "[OK] Descensos por lotes (" << Policy::name() << ")\n";
+}
+
+int main() {
+    check_batch<FrequencyPolicy>();
+    check_batch<RecentPolicy, ArenaStorage, SparseLayout>();
+    std::cout << "Batch OK\n";
+}
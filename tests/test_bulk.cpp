@@ -0,0 +1,62 @@
+#include "trie.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// build_from_sorted debe dejar el mismo trie (nodos y best_*) que insertar
+// las palabras una a una, también sobre un trie con prioridades ya cargadas.
+template <typename Policy, typename... Options>
+void check_bulk(bool sorted) {
+    std::vector<std::string> base = {"bat", "bath", "be", "cab", "cat"};
+    std::vector<std::string> more = {"a", "an", "and", "ant", "any", "batch", "bad",
+                                     "bee", "beet", "Bat", "cattle", "z"};
+    if (sorted) std::sort(more.begin(), more.end());
+
+    Trie<Policy, Options...> bulk;
+    Trie<Policy, Options...> ref;
+    for (const auto& w : base) {
+        bulk.insert(w);
+        ref.insert(w);
+    }
+    std::mt19937 rng(7);
+    for (int step = 0; step < 50; ++step) {
+        const std::string& w = base[rng() % base.size()];
+        bulk.update_priority(bulk.descend(bulk.descend_prefix(w), '$'));
+        ref.update_priority(ref.descend(ref.descend_prefix(w), '$'));
+    }
+
+    bulk.build_from_sorted(more);
+    for (const auto& w : more) ref.insert(w);
+    assert(bulk.node_count() == ref.node_count());
+
+    std::vector<std::string> all = base;
+    all.insert(all.end(), more.begin(), more.end());
+    for (int step = 0; step < 300; ++step) {
+        if (step > 0) {
+            const std::string& w = all[rng() % all.size()];
+            bulk.update_priority(bulk.descend(bulk.descend_prefix(w), '$'));
+            ref.update_priority(ref.descend(ref.descend_prefix(w), '$'));
+        }
+        for (const auto& x : all) {
+            for (size_t len = 0; len <= x.size(); ++len) {
+                auto [a, pa] = bulk.autocomplete_with_priority(bulk.descend_prefix(x.substr(0, len)));
+                auto [b, pb] = ref.autocomplete_with_priority(ref.descend_prefix(x.substr(0, len)));
+                assert((a == nullptr) == (b == nullptr));
+                assert(!a || (bulk.word(a) == ref.word(b) && pa == pb));
+            }
+        }
+    }
+    std::cout << "[OK] Carga en bloque (" << Policy::name() << (sorted ? ", ordenada" : ", desordenada") << ")\n";
+}
+
+int main() {
+    check_bulk<FrequencyPolicy>(true);
+    check_bulk<FrequencyPolicy>(false);
+    check_bulk<RecentPolicy, ArenaStorage>(true);
+    check_bulk<RecentPolicy, ArenaStorage, SparseLayout>(false);
+    check_bulk<FrequencyPolicy, ArenaStorage, TopK<4>>(true);
+    std::cout << "Bulk OK\n";
+}
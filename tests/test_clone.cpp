@@ -0,0 +1,78 @@
+#include "trie.hpp"
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Mismas prioridades y mismas sugerencias en todos los prefijos.
+template <typename TrieT>
+bool same_state(TrieT& a, TrieT& b, const std::vector<std::string>& words) {
+    if (a.node_count() != b.node_count() || a.access_counter() != b.access_counter()) return false;
+    for (const auto& w : words) {
+        auto* ta = a.descend(a.descend_prefix(w), '$');
+        auto* tb = b.descend(b.descend_prefix(w), '$');
+        if ((!ta) != (!tb) || (ta && ta->priority != tb->priority)) return false;
+        for (size_t len = 0; len <= w.size(); ++len) {
+            auto* sa = a.autocomplete(a.descend_prefix(w.substr(0, len)));
+            auto* sb = b.autocomplete(b.descend_prefix(w.substr(0, len)));
+            if ((!sa) != (!sb) || (sa && a.word(sa) != b.word(sb))) return false;
+        }
+    }
+    return true;
+}
+
+template <typename TrieT>
+void use(TrieT& T, const std::vector<std::string>& words, int n, unsigned seed) {
+    std::mt19937 rng(seed);
+    for (int i = 0; i < n; ++i) {
+        const auto& w = words[std::min(rng() % words.size(), rng() % words.size())];
+        if (auto* t = T.descend(T.descend_prefix(w), '$')) T.update_priority(t);
+    }
+}
+
+template <typename TrieT>
+void check(const char* label) {
+    std::mt19937 rng(3);
+    std::vector<std::string> words;
+    for (int i = 0; i < 2000; ++i) {
+        std::string w(1 + rng() % 6, ' ');
+        for (char& c : w) c = "abcdef"[rng() % 6];
+        words.push_back(w);
+    }
+    TrieT T;
+    for (size_t i = 0; i < words.size(); ++i) T.insert(words[i]);
+    use(T, words, 3000, 1);
+    for (size_t i = 0; i < words.size(); i += 5) T.erase(words[i]);
+
+    // Igual al original, con los nodos compactos
+    TrieT copy = T.clone();
+    assert(same_state(T, copy, words));
+    assert(copy.bytes_used() <= T.bytes_used());
+
+    // Los mismos usos (con empates) dejan a ambos iguales: el original no
+    // quedó con los padres cambiados
+    use(T, words, 4000, 2);
+    use(copy, words, 4000, 2);
+    T.flush();
+    copy.flush();
+    assert(same_state(T, copy, words));
+
+    // Y son independientes
+    TrieT other = T.clone();
+    use(other, words, 500, 3);
+    other.insert("fedcba");
+    other.flush();
+    assert(!same_state(T, other, words) && same_state(T, copy, words));
+    assert(!T.descend_prefix("fedcba"));
+    std::cout << "[OK] Copia igual e independiente (" << label << ")\n";
+}
+
+int main() {
+    check<Trie<FrequencyPolicy>>("frecuencia, heap");
+    check<Trie<RecentPolicy, ArenaStorage>>("reciente, arena");
+    check<Trie<FrequencyPolicy, ArenaStorage, SparseLayout, TopK<3>>>("TopK disperso");
+    check<Trie<FrecencyPolicy<4>, ArenaStorage, PrefixCache<2>>>("frecencia, tabla de prefijos");
+    check<Trie<FrequencyPolicy, DeferredPropagation<64>>>("diferida");
+    std::cout << "Clone OK\n";
+}
@@ -0,0 +1,61 @@
+#include "trie.hpp"
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Lectores sin bloqueo mientras un escritor inserta y actualiza prioridades.
+// Cada sugerencia leída debe ser un terminal completo cuyo string empieza con
+// el prefijo consultado.
+int main() {
+    using T = Trie<RecentPolicy, ArenaStorage, ThreadSafe>;
+    T trie;
+
+    std::vector<std::string> words;
+    for (char a = 'a'; a <= 'z'; ++a)
+        for (char b = 'a'; b <= 'z'; ++b)
+            for (char c = 'a'; c <= 'j'; ++c)
+                words.push_back(std::string{a, b, c});
+    for (size_t i = 0; i < words.size() / 2; ++i) trie.insert(words[i]);
+
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> reads{0};
+
+    auto reader = [&](unsigned seed) {
+        size_t local = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            const std::string& w = words[(seed = seed * 1103515245u + 12345u) % words.size()];
+            auto* v = trie.root();
+            for (size_t len = 1; len <= w.size() && v; ++len) {
+                v = trie.descend(v, w[len - 1]);
+                if (!v) break;
+                auto* a = trie.autocomplete(v);
+                if (a) {
+                    assert(a->is_terminal && a->str);
+                    assert(trie.word(a).substr(0, len) == std::string_view(w).substr(0, len));
+                }
+                ++local;
+            }
+        }
+        reads += local;
+    };
+
+    std::vector<std::thread> readers;
+    for (unsigned r = 0; r < 4; ++r) readers.emplace_back(reader, r + 1);
+
+    // Escritor: termina de insertar y luego martilla update_priority
+    for (size_t i = words.size() / 2; i < words.size(); ++i) trie.insert(words[i]);
+    for (size_t i = 0; i < 200000; ++i) {
+        const std::string& w = words[(i * 7919) % words.size()];
+        trie.update_priority(trie.descend(trie.descend_prefix(w), '$'));
+    }
+    stop = true;
+    for (auto& t : readers) t.join();
+
+    // Al final la raíz sugiere la última palabra actualizada
+    auto last = words[(199999 * 7919) % words.size()];
+    assert(trie.word(trie.autocomplete(trie.root())) == last);
+    std::cout << "Concurrent OK (" << reads.load() << " lecturas)\n";
+}
@@ -0,0 +1,91 @@
+#include "trie.hpp"
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// El cursor debe ver siempre lo mismo que descend_prefix sobre el texto
+// tecleado, con borrados y caracteres fuera del árbol.
+template <typename Policy, typename... Options>
+void check_cursor() {
+    std::vector<std::string> words = {"car", "card", "care", "cart", "cat", "dog", "door"};
+    Trie<Policy, Options...> T;
+    for (const auto& w : words) T.insert(w);
+
+    auto c = T.cursor();
+    assert(c.node() == T.root() && c.depth() == 0);
+    assert(c.push_char('c') && c.push_char('A') && c.push_char('r'));
+    assert(c.accept() == T.descend(T.descend_prefix("car"), '$'));
+    assert(T.word(c.suggestion()) == "car");
+    assert(!c.push_char('x') && !c.push_char('y') && c.node() == nullptr && c.depth() == 5);
+    assert(c.accept() == nullptr && c.suggestion() == nullptr);
+    c.pop_char();
+    c.pop_char();
+    assert(c.node() == T.descend_prefix("car"));
+    assert(c.push_char('t'));
+    auto* cart = c.accept();
+    assert(cart && T.word(cart) == "cart");
+    c.pop_char();
+    assert(T.word(c.suggestion()) == "cart");
+    c.reset();
+    assert(c.node() == T.root() && c.depth() == 0);
+    c.pop_char();
+    assert(c.node() == T.root());
+
+    // Sesión aleatoria contra descend_prefix + update_priority sobre una copia
+    // con los mismos usos ("car" y "cart")
+    Trie<Policy, Options...> ref;
+    for (const auto& w : words) ref.insert(w);
+    ref.update_priority(ref.descend(ref.descend_prefix("car"), '$'));
+    ref.update_priority(ref.descend(ref.descend_prefix("cart"), '$'));
+    c.reset();
+    std::mt19937 rng(9);
+    const std::string keys = "acdegortx";
+    std::string typed;
+    size_t suggested = 0;
+    for (int step = 0; step < 5000; ++step) {
+        unsigned op = rng() % 10;
+        if (typed.size() > 5) {
+            c.reset();
+            typed.clear();
+        } else if (op < 4) {
+            char k = keys[rng() % keys.size()];
+            c.push_char(k);
+            typed.push_back(k);
+        } else if (op < 8) {
+            c.pop_char();
+            if (!typed.empty()) typed.pop_back();
+        } else if (op < 9) {
+            auto* t = c.accept();
+            auto* r = ref.descend(ref.descend_prefix(typed), '$');
+            assert((t == nullptr) == (r == nullptr));
+            if (r) ref.update_priority(r);
+        } else {
+            auto* t = c.accept_suggestion();
+            auto* r = ref.autocomplete(ref.descend_prefix(typed));
+            assert((t == nullptr) == (r == nullptr));
+            if (r) {
+                assert(T.word(t) == ref.word(r));
+                ref.update_priority(r);
+            }
+        }
+        assert(c.depth() == typed.size());
+        auto* v = ref.descend_prefix(typed);
+        assert((c.node() == nullptr) == (v == nullptr));
+        auto* s = c.suggestion();
+        auto* rs = ref.autocomplete(v);
+        assert((s == nullptr) == (rs == nullptr));
+        assert(!s || (T.word(s) == ref.word(rs) && s->priority == rs->priority));
+        if (s) ++suggested;
+    }
+    assert(suggested > 1000);
+    std::cout << "[OK] Cursor (" << Policy::name() << ")\n";
+}
+
+int main() {
+    check_cursor<FrequencyPolicy>();
+    check_cursor<RecentPolicy, ArenaStorage, SparseLayout>();
+    check_cursor<FrequencyPolicy, ArenaStorage, TopK<3>>();
+    std::cout << "Cursor OK\n";
+}
@@ -0,0 +1,88 @@
+#include "dawg.hpp"
+#include "trie.hpp"
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// El autómata debe responder lo mismo que el trie del que sale: existencia
+// de cada prefijo, palabras completas y mejor sugerencia.
+template <typename TrieT>
+void same_answers(TrieT& T, const Dawg& D, const std::vector<std::string>& queries) {
+    std::string rest;
+    for (const auto& q : queries) {
+        auto v = T.root();
+        Dawg::State s = D.root();
+        for (size_t len = 0; len <= q.size(); ++len) {
+            if (len > 0) {
+                v = T.descend(v, q[len - 1]);
+                s = D.descend(s, q[len - 1]);
+            }
+            assert((v == nullptr) == (s == Dawg::none));
+            if (!v) break;
+            assert((T.descend(v, '$') != nullptr) == D.is_final(s));
+            auto* t = T.autocomplete(v);
+            assert((t != nullptr) == D.completion(s, rest));
+            if (t) {
+                std::string_view w = T.word(t);
+                assert(D.autocomplete(q.substr(0, len)) == w);
+                assert(D.completes_to(s, w.substr(len)));
+                assert(w.size() == len || !D.completes_to(s, w.substr(len, w.size() - len - 1)));
+            }
+        }
+    }
+}
+
+int main() {
+    {
+        // Sin prioridades todos los sufijos "at", "ats" se comparten
+        Trie<FrequencyPolicy> T;
+        for (const char* w : {"cat", "cats", "bat", "bats"}) T.insert(w);
+        Dawg D(T);
+        assert(T.node_count() == 13 && D.state_count() == 5);
+        assert(D.contains("bats") && D.contains("cat") && !D.contains("ca") && !D.contains("dog"));
+        assert(D.autocomplete("c").empty());
+
+        // "cat" le gana a "cats" pero "bats" a "bat": las ramas ya no se funden
+        auto use = [&](const char* w) { T.update_priority(T.descend(T.descend_prefix(w), '$')); };
+        use("cat");
+        use("cats");
+        use("cat");
+        use("bats");
+        Dawg P(T);
+        assert(P.state_count() == 8);
+        assert(P.autocomplete("c") == "cat" && P.autocomplete("b") == "bats" && P.autocomplete("") == "cat");
+        same_answers(T, P, {"cats", "bats", "cab", "x"});
+        std::cout << "[OK] Estados compartidos según la sugerencia\n";
+    }
+
+    {
+        // Diccionario aleatorio con prioridades sesgadas
+        std::mt19937 rng(17);
+        std::vector<std::string> words;
+        for (int i = 0; i < 3000; ++i) {
+            std::string w(1 + rng() % 7, 'a');
+            for (char& c : w) c = static_cast<char>('a' + rng() % 5);
+            words.push_back(w);
+        }
+        Trie<FrequencyPolicy, ArenaStorage, SparseLayout> T;
+        for (const auto& w : words) T.insert(w);
+        Dawg empty(T);
+        same_answers(T, empty, words);
+
+        for (int i = 0; i < 20000; ++i) {
+            const auto& w = words[std::min(rng() % words.size(), rng() % words.size())];
+            T.update_priority(T.descend(T.descend_prefix(w), '$'));
+        }
+        Dawg D(T);
+        assert(D.state_count() < T.node_count());
+        std::vector<std::string> queries = words;
+        queries.push_back("");
+        queries.push_back("abcdeabcde");
+        same_answers(T, D, queries);
+        std::cout << "[OK] Paridad con el trie (" << D.state_count() << " estados, "
+                  << T.node_count() << " nodos)\n";
+    }
+    std::cout << "Dawg OK\n";
+}
@@ -0,0 +1,67 @@
+#include "trie.hpp"
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+template <typename A, typename B>
+void same_suggestions(A& a, B& b, const std::vector<std::string>& words) {
+    for (const auto& x : words) {
+        for (size_t len = 0; len <= x.size(); ++len) {
+            auto [ta, pa] = a.autocomplete_with_priority(a.descend_prefix(x.substr(0, len)));
+            auto [tb, pb] = b.autocomplete_with_priority(b.descend_prefix(x.substr(0, len)));
+            assert((ta == nullptr) == (tb == nullptr));
+            assert(!ta || (a.word(ta) == b.word(tb) && pa == pb));
+        }
+    }
+}
+
+// Tras flush(), el modo diferido debe sugerir exactamente lo mismo que
+// propagar en cada actualización.
+template <typename Policy, typename... Options>
+void check_deferred() {
+    std::vector<std::string> words = {"a", "an", "and", "ant", "any", "bat", "bath",
+                                      "batch", "bad", "be", "bee", "beet", "cab", "cat"};
+    Trie<Policy, Options...> now;
+    Trie<Policy, DeferredPropagation<>, Options...> later;
+    Trie<Policy, DeferredPropagation<7>, Options...> every7;
+    for (const auto& w : words) {
+        now.insert(w);
+        later.insert(w);
+        every7.insert(w);
+    }
+
+    std::mt19937 rng(13);
+    for (int step = 0; step < 3000; ++step) {
+        const std::string& w = words[rng() % words.size()];
+        now.update_priority(now.descend(now.descend_prefix(w), '$'));
+        later.update_priority(later.descend(later.descend_prefix(w), '$'));
+        every7.update_priority(every7.descend(every7.descend_prefix(w), '$'));
+        assert(every7.pending_updates() == static_cast<size_t>((step + 1) % 7));
+        if (every7.pending_updates() == 0) same_suggestions(now, every7, words);
+
+        if (step % 50 == 49) {
+            // Una inserción con actualizaciones pendientes no debe perderlas
+            if (step == 1499) {
+                now.insert("bathe");
+                later.insert("bathe");
+                every7.insert("bathe");
+                words.push_back("bathe");
+            }
+            assert(later.pending_updates() == 50);
+            assert(later.flush() > 0);
+            assert(later.pending_updates() == 0 && later.flush() == 0);
+            same_suggestions(now, later, words);
+        }
+    }
+    std::cout << "[OK] Propagación diferida (" << Policy::name() << ")\n";
+}
+
+int main() {
+    check_deferred<FrequencyPolicy>();
+    check_deferred<RecentPolicy, ArenaStorage>();
+    check_deferred<FrequencyPolicy, ArenaStorage, SparseLayout, TopK<3>>();
+    check_deferred<FullRecompute<RecentPolicy>>();
+    std::cout << "Deferred OK\n";
+}
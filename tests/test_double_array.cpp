@@ -0,0 +1,91 @@
+#include "double_array_trie.hpp"
+#include "trie.hpp"
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Ambas estructuras deben responder lo mismo en cada prefijo: existencia,
+// terminal y mejor sugerencia con su prioridad.
+template <typename TrieT, typename DaT>
+void same_answers(TrieT& T, const DaT& D, const std::vector<std::string>& queries) {
+    for (const auto& q : queries) {
+        auto v = T.root();
+        auto s = D.root();
+        for (size_t len = 0; len <= q.size(); ++len) {
+            if (len > 0) {
+                v = T.descend(v, q[len - 1]);
+                s = D.descend(s, q[len - 1]);
+            }
+            assert((v == nullptr) == !s);
+            if (!v) break;
+            assert((T.descend(v, '$') != nullptr) == bool(D.descend(s, '$')));
+            auto* t = T.autocomplete(v);
+            auto* d = D.autocomplete(s);
+            assert((t != nullptr) == (d != nullptr));
+            if (t) assert(T.word(t) == D.word(d) && t->priority == d->priority);
+        }
+    }
+}
+
+template <typename Policy>
+void check_random(const char* label) {
+    std::mt19937 rng(11);
+    std::vector<std::string> words;
+    for (int i = 0; i < 3000; ++i) {
+        std::string w(1 + rng() % 7, 'a');
+        for (char& c : w) c = static_cast<char>('a' + rng() % 6);
+        words.push_back(w);
+    }
+    Trie<Policy> T;
+    for (const auto& w : words) T.insert(w);
+    auto use = [&](const std::string& w) {
+        T.update_priority(T.descend(T.descend_prefix(w), '$'));
+    };
+    for (int i = 0; i < 5000; ++i) use(words[std::min(rng() % words.size(), rng() % words.size())]);
+
+    // Se convierte a mitad de camino y se siguen aplicando las mismas actualizaciones
+    DoubleArrayTrie<Policy> D(T);
+    assert(D.node_count() == T.node_count() && D.capacity() >= D.node_count());
+    same_answers(T, D, words);
+    for (int i = 0; i < 20000; ++i) {
+        const auto& w = words[std::min(rng() % words.size(), rng() % words.size())];
+        use(w);
+        D.update_priority(D.descend(D.descend_prefix(w), '$'));
+    }
+    assert(D.access_counter() == T.access_counter());
+    same_answers(T, D, words);
+    std::cout << "[OK] Paridad con el trie (" << label << ", " << D.capacity() << " casilleros para "
+              << D.node_count() << " estados)\n";
+}
+
+int main() {
+    {
+        Trie<FrequencyPolicy> T;
+        for (const char* w : {"car", "cart", "cat", "dog"}) T.insert(w);
+        DoubleArrayTrie<FrequencyPolicy> D(T);
+        assert(D.node_count() == T.node_count());
+        assert(D.descend_prefix("cart") && !D.descend_prefix("cab") && !D.descend_prefix("c-t"));
+        assert(D.descend(D.descend_prefix("CAR"), '$')->is_terminal);
+        assert(!D.descend(D.descend_prefix("ca"), '$'));
+        assert(!D.autocomplete(D.descend_prefix("c")));     // sin prioridades no se sugiere
+
+        auto use = [&](const char* w) { D.update_priority(D.descend(D.descend_prefix(w), '$')); };
+        use("cart");
+        assert(D.word(D.autocomplete(D.root())) == "cart");
+        use("cat");
+        use("cat");
+        assert(D.word(D.autocomplete(D.descend_prefix("c"))) == "cat");
+        assert(D.word(D.autocomplete(D.descend_prefix("car"))) == "cart");
+        assert(D.autocomplete(D.descend_prefix("cat"))->priority == 2);
+        // Un terminal se sugiere a sí mismo aunque no tenga prioridad
+        assert(D.word(D.autocomplete(D.descend(D.descend_prefix("dog"), '$'))) == "dog");
+        std::cout << "[OK] Descenso, terminales y sugerencias\n";
+    }
+
+    check_random<FrequencyPolicy>("frecuencia");
+    check_random<RecentPolicy>("recencia");
+    check_random<FrecencyPolicy<1>>("frecencia");
+    std::cout << "DoubleArrayTrie OK\n";
+}
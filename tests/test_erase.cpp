@@ -0,0 +1,144 @@
+#include "trie.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+// Compara cada prefijo contra la prioridad máxima de las palabras vivas y la
+// cantidad de nodos contra un trie construido desde cero con ellas.
+template <typename TrieT>
+void check(TrieT& T, const std::map<std::string, uint64_t>& live) {
+    T.flush();
+    TrieT fresh;
+    for (const auto& [w, p] : live) fresh.insert(w);
+    assert(T.node_count() == fresh.node_count());
+
+    std::vector<std::string> prefixes = {""};
+    for (const auto& [w, p] : live) {
+        for (size_t len = 1; len <= w.size(); ++len) prefixes.push_back(w.substr(0, len));
+    }
+    for (const auto& pref : prefixes) {
+        std::vector<uint64_t> below;
+        for (const auto& [w, p] : live) {
+            if (w.compare(0, pref.size(), pref) == 0 && p > 0) below.push_back(p);
+        }
+        std::sort(below.rbegin(), below.rend());
+        auto* v = T.descend_prefix(pref);
+        assert(v);
+        auto [t, p] = T.autocomplete_with_priority(v);
+        assert(p == (below.empty() ? 0 : below[0]));
+        if (p > 0) assert(live.at(std::string(T.word(t))) == p && T.word(t).substr(0, pref.size()) == pref);
+        if constexpr (TrieT::topk > 0) {
+            auto top = T.autocomplete_topk(v, TrieT::topk);
+            for (size_t i = 0; i < top.size() && i < below.size(); ++i) assert(top[i]->priority == below[i]);
+        }
+    }
+}
+
+template <typename TrieT>
+void check_random(const char* label) {
+    TrieT T;
+    std::map<std::string, uint64_t> live;
+    std::mt19937 rng(5);
+    auto random_word = [&] {
+        std::string w(1 + rng() % 4, 'a');
+        for (char& c : w) c = static_cast<char>('a' + rng() % 3);
+        return w;
+    };
+
+    for (int round = 0; round < 4; ++round) {
+        for (int step = 0; step < 1500; ++step) {
+            std::string w = random_word();
+            switch (rng() % 4) {
+                case 0:
+                    T.insert(w);
+                    live.emplace(w, 0);
+                    break;
+                case 1:
+                    assert(T.erase(w) == (live.erase(w) == 1));
+                    break;
+                default:
+                    if (live.count(w)) {
+                        T.update_priority(T.descend(T.descend_prefix(w), '$'));
+                        ++live[w];
+                    }
+            }
+        }
+        check(T, live);
+
+        size_t bytes = T.bytes_used() + T.string_bytes();
+        size_t released = T.compact();
+        assert(T.free_nodes() == 0);
+        assert(T.bytes_used() + T.string_bytes() + released == bytes);
+        check(T, live);
+    }
+    std::cout << "[OK] Borrado y compactación (" << label << ")\n";
+}
+
+int main() {
+    {
+        Trie<FrequencyPolicy> T;
+        for (const char* w : {"car", "cart", "cat", "dog"}) T.insert(w);
+        auto use = [&](const char* w) { T.update_priority(T.descend(T.descend_prefix(w), '$')); };
+        use("cat");
+        use("cat");
+        use("cart");
+        assert(T.word(T.autocomplete(T.descend_prefix("ca"))) == "cat");
+
+        size_t nodes = T.node_count();
+        assert(T.erase("cat"));                      // quita 't' y su '$'
+        assert(T.node_count() == nodes - 2 && T.free_nodes() == 2);
+        assert(!T.descend_prefix("cat"));
+        assert(T.word(T.autocomplete(T.descend_prefix("c"))) == "cart");
+
+        assert(T.erase("car"));                      // "cart" sigue: solo su '$'
+        assert(T.node_count() == nodes - 3);
+        assert(T.descend_prefix("car") && !T.descend(T.descend_prefix("car"), '$'));
+        assert(!T.erase("car") && !T.erase("ca") && !T.erase("zebra"));
+
+        // Reinsertar reutiliza los nodos liberados, con prioridad nueva
+        size_t bytes = T.bytes_used();
+        T.insert("cat");
+        assert(T.free_nodes() == 1 && T.bytes_used() == bytes);
+        assert(T.descend(T.descend_prefix("cat"), '$')->priority == 0);
+
+        assert(T.erase("cart") && T.erase("cat") && T.erase("dog"));
+        assert(T.node_count() == 1 && !T.autocomplete(T.root()));
+        T.compact();
+        assert(T.node_count() == 1 && T.free_nodes() == 0);
+        std::cout << "[OK] Poda de nodos vacíos\n";
+    }
+
+    {
+        // Tras compactar, con la arena los nodos quedan en preorden
+        Trie<FrequencyPolicy, ArenaStorage> T;
+        for (const char* w : {"b", "ab", "abc", "a"}) T.insert(w);
+        T.erase("b");
+        T.compact();
+        std::vector<const void*> seen;
+        std::vector<decltype(T.root())> stack{T.root()};
+        while (!stack.empty()) {
+            auto* v = stack.back();
+            stack.pop_back();
+            seen.push_back(v);
+            for (char c : std::string("$cba")) {
+                if (auto* u = T.descend(v, c)) stack.push_back(u);
+            }
+        }
+        for (size_t i = 1; i < seen.size(); ++i) {
+            assert(static_cast<const char*>(seen[i]) - static_cast<const char*>(seen[i - 1]) ==
+                   static_cast<std::ptrdiff_t>(sizeof(*T.root())));
+        }
+        std::cout << "[OK] Orden DFS tras compact\n";
+    }
+
+    check_random<Trie<FrequencyPolicy>>("heap");
+    check_random<Trie<FrequencyPolicy, ArenaStorage, SparseLayout>>("arena dispersa");
+    check_random<Trie<FullRecompute<FrequencyPolicy>, ArenaStorage>>("recálculo completo");
+    check_random<Trie<FrequencyPolicy, ArenaStorage, SparseLayout, TopK<3>>>("TopK<3>");
+    check_random<Trie<FrequencyPolicy, DeferredPropagation<>>>("diferida");
+    std::cout << "Erase OK\n";
+}
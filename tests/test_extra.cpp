@@ -28,7 +28,7 @@ int main() {
         auto a = T.autocomplete(v_pref);
         assert(a && a->is_terminal);
         std::cout << "[OK] Empate manejado con prioridad estable ("
-                  << *(a->str) << ")\n";
+                  << T.word(a) << ")\n";
     }
 
     {
@@ -44,15 +44,15 @@ int main() {
         T.update_priority(t_dog);
         auto v_d = T.descend_prefix("do");
         auto a1 = T.autocomplete(v_d);
-        assert(a1 && *(a1->str) == "dog");
+        assert(a1 && T.word(a1) == "dog");
 
         T.update_priority(t_door);
         auto a2 = T.autocomplete(v_d);
-        assert(a2 && *(a2->str) == "door");
+        assert(a2 && T.word(a2) == "door");
 
         T.update_priority(t_doom);
         auto a3 = T.autocomplete(v_d);
-        assert(a3 && *(a3->str) == "doom");
+        assert(a3 && T.word(a3) == "doom");
 
         std::cout << "[OK] Variante 'reciente' cambia correctamente de sugerencia\n";
     }
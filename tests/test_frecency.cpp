@@ -0,0 +1,101 @@
+#include "trie.hpp"
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Cada prefijo debe sugerir la clave máxima entre sus palabras, calculada
+// aparte repitiendo touch/rebase de la política sobre un arreglo plano.
+template <typename TrieT>
+void check_against_flat(const char* label) {
+    using Policy = typename TrieT::policy_type;
+    using Counter = typename Policy::Counter;
+    std::vector<std::string> words = {"a", "an", "and", "ant", "any", "bat", "bath",
+                                      "batch", "bad", "be", "bee", "beet", "cab", "cat"};
+    TrieT T;
+    for (const auto& w : words) T.insert(w);
+
+    std::vector<Counter> keys(words.size(), 0);
+    Counter clock = 0;
+    std::mt19937 rng(21);
+    for (int step = 0; step < 60000; ++step) {
+        // Pocas palabras concentran casi todos los usos; "cab" y "cat" dejan
+        // de usarse y terminan con la clave mínima
+        size_t pool = step < 20000 ? words.size() : words.size() - 2;
+        size_t i = (rng() % 8 == 0) ? rng() % pool : rng() % 3;
+        T.update_priority(T.descend(T.descend_prefix(words[i]), '$'));
+        Policy::touch(keys[i], clock);
+        if (Policy::epoch_full(clock)) {
+            Policy::advance(clock);
+            for (auto& k : keys) k = Policy::rebase(k);
+        }
+        assert(T.access_counter() == clock);
+
+        if (step % 997 == 0 || step == 59999) {
+            T.flush();
+            for (const auto& x : words) {
+                for (size_t len = 0; len <= x.size(); ++len) {
+                    std::string pref = x.substr(0, len);
+                    Counter best = 0;
+                    for (size_t j = 0; j < words.size(); ++j) {
+                        if (words[j].compare(0, len, pref) == 0) best = std::max(best, keys[j]);
+                    }
+                    auto [t, p] = T.autocomplete_with_priority(T.descend_prefix(pref));
+                    assert(p == best && (best == 0 || t->priority == best));
+                }
+            }
+        }
+    }
+    assert(keys[12] == 1 && keys[13] == 1);
+    assert(T.renormalizations() == 60000 / Policy::epoch_ticks - 1);
+    std::cout << "[OK] Renormalización de la época (" << label << ")\n";
+}
+
+int main() {
+    {
+        // Usos viejos pierden peso: 5 usos recientes superan a 10 antiguos
+        Trie<FrecencyPolicy<4>> T;
+        Trie<FrequencyPolicy> F;
+        for (const char* w : {"old", "new"}) {
+            T.insert(w);
+            F.insert(w);
+        }
+        auto use = [&](const char* w, int n) {
+            for (int i = 0; i < n; ++i) {
+                T.update_priority(T.descend(T.descend_prefix(w), '$'));
+                F.update_priority(F.descend(F.descend_prefix(w), '$'));
+            }
+        };
+        use("old", 10);
+        use("new", 3);
+        assert(T.word(T.autocomplete(T.root())) == "old");
+        use("new", 2);
+        assert(T.word(T.autocomplete(T.root())) == "new");
+        assert(F.word(F.autocomplete(F.root())) == "old");
+        std::cout << "[OK] Decaimiento exponencial\n";
+    }
+
+    {
+        // La clave es log2 de la suma de 2^(t/HalfLife) de cada uso, en punto fijo
+        using P = FrecencyPolicy<8>;
+        P::Counter once = 0, twice = 0, other = 0, clock = 0;
+        P::touch(twice, clock);
+        P::touch(twice, clock);
+        for (int i = 0; i < 7; ++i) P::touch(other, clock);
+        P::touch(once, clock);
+        assert(clock == 10);
+        assert(once == P::epoch_shift + 10 * 65536 / 8);
+        double expected = P::epoch_shift + std::log2(std::exp2(1 / 8.0) + std::exp2(2 / 8.0)) * 65536;
+        assert(std::fabs(twice - expected) <= 1);
+        assert(P::rebase(0) == 0 && P::rebase(once) == 10 * 65536 / 8 && P::rebase(P::epoch_shift) == 1);
+        std::cout << "[OK] Claves en el dominio logarítmico\n";
+    }
+
+    // HalfLife = 1: la época avanza cada 8192 usos
+    check_against_flat<Trie<FrecencyPolicy<1>>>("incremental");
+    check_against_flat<Trie<FullRecompute<FrecencyPolicy<1>>>>("recálculo completo");
+    check_against_flat<Trie<FrecencyPolicy<1>, ArenaStorage, SparseLayout, TopK<3>>>("TopK<3>");
+    check_against_flat<Trie<FrecencyPolicy<1>, DeferredPropagation<100>>>("diferida");
+    std::cout << "Frecency OK\n";
+}
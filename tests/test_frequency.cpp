@@ -22,6 +22,6 @@ int main() {
 
     auto v_c = T.descend_prefix("c");
     auto a   = T.autocomplete(v_c);
-    assert(a && a->is_terminal && *(a->str) == "cat");
+    assert(a && a->is_terminal && T.word(a) == "cat");
     std::cout << "Frequency OK\n";
 }
@@ -0,0 +1,61 @@
+#include "latency_histogram.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Percentil exacto con la misma definición de rango que el histograma.
+uint64_t exact(std::vector<uint64_t> v, double q) {
+    std::sort(v.begin(), v.end());
+    size_t rank = std::max<size_t>(1, static_cast<size_t>(std::ceil(q * v.size())));
+    return v[rank - 1];
+}
+
+int main() {
+    {
+        LatencyHistogram<> h;
+        assert(h.count() == 0 && h.percentile(0.5) == 0 && h.mean() == 0.0);
+        for (uint64_t v = 1; v <= 100; ++v) h.record(v);     // bajo 128: exacto
+        assert(h.count() == 100 && h.min() == 1 && h.max() == 100);
+        assert(h.percentile(0.5) == 50 && h.percentile(0.99) == 99 && h.percentile(1.0) == 100);
+        assert(h.percentile(0.0) == 1 && h.mean() == 50.5);
+        std::cout << "[OK] Valores pequeños exactos\n";
+    }
+
+    {
+        // Cola larga: el error relativo queda bajo 2^-7 en todas las escalas
+        std::mt19937_64 rng(9);
+        std::lognormal_distribution<double> dist(5.0, 2.0);
+        std::vector<uint64_t> all, first, second;
+        LatencyHistogram<> a, b, h;
+        for (int i = 0; i < 200000; ++i) {
+            uint64_t v = static_cast<uint64_t>(dist(rng));
+            all.push_back(v);
+            h.record(v);
+            (i % 3 ? a : b).record(v);
+        }
+        for (double q : {0.1, 0.5, 0.9, 0.99, 0.999, 0.9999}) {
+            uint64_t want = exact(all, q), got = h.percentile(q);
+            assert(got >= want && static_cast<double>(got - want) <= want / 128.0 + 1);
+        }
+        assert(h.max() == *std::max_element(all.begin(), all.end()) && h.percentile(1.0) == h.max());
+
+        // Combinar dos mitades da el mismo histograma
+        a.merge(b);
+        assert(a.count() == h.count() && a.min() == h.min() && a.max() == h.max());
+        for (double q : {0.5, 0.99, 0.999}) assert(a.percentile(q) == h.percentile(q));
+        a.clear();
+        assert(a.count() == 0 && a.max() == 0);
+        std::cout << "[OK] Percentiles con error relativo acotado\n";
+    }
+
+    {
+        LatencyHistogram<> h;
+        h.record(UINT64_MAX);
+        h.record(0);
+        assert(h.percentile(0.5) == 0 && h.percentile(1.0) == UINT64_MAX);
+        std::cout << "[OK] Extremos\n";
+    }
+    std::cout << "Latency histogram OK\n";
+}
@@ -0,0 +1,102 @@
+#include "node_children.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+static_assert(sizeof(SparseChildren<uint32_t, 27>) == 16);
+
+template <typename Link, size_t N>
+std::vector<Link> children(const DenseChildren<Link, N>& d) {
+    std::vector<Link> out;
+    d.for_each([&](Link u) { out.push_back(u); });
+    return out;
+}
+
+template <typename Link, size_t N>
+std::vector<Link> children(const SparseChildren<Link, N>& s) {
+    std::vector<Link> out;
+    s.for_each([&](Link u) { out.push_back(u); });
+    return out;
+}
+
+// Capacidad esperada: potencia de 2 mayor o igual a la cantidad de hijos.
+size_t expected_capacity(size_t n) {
+    size_t cap = n ? 1 : 0;
+    while (cap < n) cap <<= 1;
+    return cap;
+}
+
+// Misma secuencia de set/erase sobre ambas representaciones: mismos hijos en
+// el mismo orden, y los bytes que reportan set/erase suman heap_bytes().
+template <typename Link, size_t N>
+void check_against_dense(const char* label, unsigned seed) {
+    std::mt19937 rng(seed);
+    DenseChildren<Link, N> dense;
+    SparseChildren<Link, N> sparse;
+    size_t bytes = 0, max_children = 0;
+    bool shrank_to_empty = false;
+    for (int step = 0; step < 12000; ++step) {
+        int idx = static_cast<int>(rng() % N);
+        // Fases que llenan y vacían el nodo para pasar por todas las capacidades;
+        // a mitad de cada fase se mezclan inserciones y borrados
+        bool filling = (step / 1500) % 2 == 0;
+        bool mixed = step % 1500 >= 500 && step % 1500 < 700;
+        if (mixed ? rng() % 2 == 0 : filling) {
+            Link u = static_cast<Link>(1 + rng() % 1000);
+            bytes += sparse.set(idx, u);
+            dense.set(idx, u);
+        } else {
+            size_t freed = sparse.erase(idx);
+            assert(freed <= bytes);
+            bytes -= freed;
+            dense.erase(idx);
+        }
+        for (int i = 0; i < static_cast<int>(N); ++i) assert(sparse.get(i) == dense.get(i));
+        auto kids = children(sparse);
+        assert(kids == children(dense));
+        assert(sparse.empty() == dense.empty() && sparse.empty() == kids.empty());
+        assert(sparse.scan_width() == kids.size());
+        assert(sparse.heap_bytes() == expected_capacity(kids.size()) * sizeof(Link));
+        assert(sparse.heap_bytes() == bytes);
+        max_children = std::max(max_children, kids.size());
+        shrank_to_empty |= max_children > 1 && kids.empty();
+    }
+    assert(max_children == N && shrank_to_empty);
+
+    // Reemplazar un hijo existente no cambia la capacidad
+    sparse.set(0, 7);
+    size_t before = sparse.heap_bytes();
+    assert(sparse.set(0, 9) == 0 && sparse.get(0) == 9 && sparse.heap_bytes() == before);
+
+    // Mover deja al origen vacío
+    SparseChildren<Link, N> moved(std::move(sparse));
+    assert(moved.get(0) == 9 && sparse.empty() && sparse.heap_bytes() == 0);
+    std::cout << "[OK] Disperso igual al denso (" << label << ")\n";
+}
+
+int main() {
+    {
+        SparseChildren<uint32_t, 27> s;
+        assert(s.empty() && s.heap_bytes() == 0 && s.get(5) == 0);
+        assert(s.set(5, 50) == 4);                  // 0 -> 1
+        assert(s.set(2, 20) == 4);                  // 1 -> 2
+        assert(s.set(9, 90) == 8);                  // 2 -> 4
+        assert(s.set(0, 1) == 0);                   // cabe
+        assert(children(s) == (std::vector<uint32_t>{1, 20, 50, 90}));
+        assert(s.set(26, 260) == 16);               // 4 -> 8
+        assert(s.erase(3) == 0);                    // no estaba
+        assert(s.erase(26) == 16);                  // 8 -> 4
+        assert(s.erase(0) == 0 && s.erase(9) == 8); // 4 -> 4 -> 2
+        assert(s.erase(2) == 4 && s.erase(5) == 4); // 2 -> 1 -> 0
+        assert(s.empty() && s.heap_bytes() == 0);
+        std::cout << "[OK] Crecimiento y reducción de capacidad\n";
+    }
+
+    check_against_dense<uint32_t, 27>("Σ = 27, enlaces de 32 bits", 1);
+    check_against_dense<uint64_t, 37>("Σ = 37, bitmap de 64 bits", 2);
+    check_against_dense<uint32_t, 165>("Σ = 165, bitmap de 3 palabras", 3);
+    std::cout << "Node children OK\n";
+}
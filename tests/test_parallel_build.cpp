@@ -0,0 +1,61 @@
+#include "trie.hpp"
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Compara dos subárboles nodo a nodo: mismos hijos, terminales, palabras y best_*.
+template <typename A, typename B>
+size_t same_tree(const A& ta, typename A::Node* a, const B& tb, typename B::Node* b) {
+    assert((a == nullptr) == (b == nullptr));
+    if (!a) return 0;
+    assert(a->is_terminal == b->is_terminal);
+    assert(a->priority == b->priority);
+    assert((a->str == 0) == (b->str == 0));
+    assert(!a->str || ta.word(a) == tb.word(b));
+    auto [ba, pa] = ta.autocomplete_with_priority(a);
+    auto [bb, pb] = tb.autocomplete_with_priority(b);
+    assert((ba == nullptr) == (bb == nullptr));
+    assert(!ba || (ta.word(ba) == tb.word(bb) && pa == pb));
+    size_t nodes = 1;
+    for (char c = 'a'; c <= 'z'; ++c) nodes += same_tree(ta, ta.descend(a, c), tb, tb.descend(b, c));
+    return nodes + same_tree(ta, ta.descend(a, '$'), tb, tb.descend(b, '$'));
+}
+
+template <typename Policy, typename... Options>
+void check_parallel(unsigned threads) {
+    std::mt19937 rng(threads);
+    std::vector<std::string> words = {"", "42", "Bat", "bat", "c-a-t"};
+    for (int i = 0; i < 3000; ++i) {
+        std::string w;
+        size_t len = 1 + rng() % 8;
+        for (size_t j = 0; j < len; ++j) w.push_back(static_cast<char>('a' + rng() % (j == 0 ? 26 : 4)));
+        words.push_back(w);
+    }
+
+    Trie<Policy, Options...> seq;
+    Trie<Policy, Options...> par;
+    for (const auto& w : words) seq.insert(w);
+    par.build_parallel(words, threads);
+    assert(par.node_count() == seq.node_count());
+    assert(same_tree(par, par.root(), seq, seq.root()) == seq.node_count());
+
+    for (int step = 0; step < 2000; ++step) {
+        const std::string& w = words[5 + rng() % (words.size() - 5)];   // solo letras
+        seq.update_priority(seq.descend(seq.descend_prefix(w), '$'));
+        par.update_priority(par.descend(par.descend_prefix(w), '$'));
+    }
+    assert(same_tree(par, par.root(), seq, seq.root()) == seq.node_count());
+    std::cout << "[OK] Construcción paralela (" << Policy::name() << ", " << threads << " hilos)\n";
+}
+
+int main() {
+    for (unsigned threads : {1u, 2u, 4u}) {
+        check_parallel<FrequencyPolicy>(threads);
+        check_parallel<RecentPolicy, ArenaStorage>(threads);
+        check_parallel<FrequencyPolicy, ArenaStorage, SparseLayout, TopK<4>>(threads);
+        check_parallel<RecentPolicy, ArenaStorage, ThreadSafe>(threads);
+    }
+    std::cout << "Parallel build OK\n";
+}
@@ -0,0 +1,108 @@
+#include "trie.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// 1 + 26 + 26^2 + 26^3 entradas de dos enlaces
+static_assert(Trie<FrequencyPolicy, PrefixCache<3>>::prefix_cache_depth == 3);
+static_assert(trie_detail::PrefixTable<uint32_t, LowercaseAlphabet, 3>::capacity() == 18279);
+static_assert(trie_detail::PrefixTable<uint32_t, LowercaseAlphabet, 3>::bytes() == 18279 * 8);
+static_assert(sizeof(Trie<FrequencyPolicy, PrefixCache<2>>::Node) == sizeof(Trie<FrequencyPolicy>::Node));
+
+// lookup_prefix responde lo mismo que descender y autocompletar, para todos
+// los prefijos de las palabras y para algunos que no están o no usan la tabla.
+template <typename TrieT>
+void check(TrieT& T, const std::vector<std::string>& words) {
+    std::vector<std::string> prefixes = {"", "q", "qz", "zzq", "a1", "ab$", "A", "Ab", "abcdefgh"};
+    for (const auto& w : words) {
+        for (size_t len = 1; len <= w.size(); ++len) prefixes.push_back(w.substr(0, len));
+    }
+    for (const auto& pref : prefixes) {
+        auto* v = T.descend_prefix(pref);
+        auto m = T.lookup_prefix(pref);
+        assert(m.node == v && m.best == T.autocomplete(v));
+        // La tabla solo responde prefijos cortos que su alfabeto puede indexar
+        using A = typename TrieT::Alphabet;
+        bool indexable = pref.size() <= TrieT::prefix_cache_depth &&
+                         std::all_of(pref.begin(), pref.end(), [](char c) {
+                             return A::index(c) >= 0 && A::index(c) != A::end_index;
+                         });
+        assert(m.from_table == indexable);
+    }
+}
+
+template <typename TrieT>
+void check_random(const char* label) {
+    std::mt19937 rng(11);
+    std::vector<std::string> words;
+    for (int i = 0; i < 1500; ++i) {
+        std::string w(1 + rng() % 6, ' ');
+        for (char& c : w) c = "abcde"[rng() % 5];
+        words.push_back(w);
+    }
+    TrieT T;
+    for (size_t i = 0; i < words.size() / 2; ++i) T.insert(words[i]);
+    check(T, words);
+    for (int i = 0; i < 5000; ++i) {
+        const auto& w = words[std::min(rng() % words.size(), rng() % words.size())];
+        if (i % 7 == 0) T.insert(w);
+        if (auto* t = T.descend(T.descend_prefix(w), '$')) T.update_priority(t);
+        if (i % 500 == 0) {
+            T.flush();
+            check(T, words);
+        }
+    }
+    T.flush();
+    check(T, words);
+
+    // Borrar deja vacías las entradas de los nodos que desaparecen
+    for (size_t i = 0; i < words.size(); i += 3) T.erase(words[i]);
+    check(T, words);
+    T.compact();
+    check(T, words);
+    std::cout << "[OK] Coherencia con el árbol (" << label << ")\n";
+}
+
+int main() {
+    {
+        Trie<FrequencyPolicy, PrefixCache<2>> T;
+        for (const char* w : {"car", "cat", "dog"}) T.insert(w);
+        auto m = T.lookup_prefix("ca");
+        assert(m.node == T.descend_prefix("ca") && !m.best);     // sin usos no hay sugerencia
+        T.update_priority(T.descend(T.descend_prefix("cat"), '$'));
+        assert(T.word(T.lookup_prefix("c").best) == "cat" && T.word(T.lookup_prefix("").best) == "cat");
+        for (int i = 0; i < 2; ++i) T.update_priority(T.descend(T.descend_prefix("dog"), '$'));
+        assert(T.word(T.lookup_prefix("").best) == "dog" && T.word(T.lookup_prefix("c").best) == "cat");
+        assert(T.word(T.lookup_prefix("cat").best) == "cat");         // más largo que D: desciende
+        assert(T.lookup_prefix("ca").from_table && !T.lookup_prefix("cat").from_table);
+        assert(T.lookup_prefix("C").from_table && !T.lookup_prefix("c1").from_table);
+        assert(!T.lookup_prefix("cx").node && !T.lookup_prefix("cx").best);
+        T.erase("dog");
+        assert(!T.lookup_prefix("d").node && !T.lookup_prefix("do").node);
+        assert(T.word(T.lookup_prefix("").best) == "cat");
+        assert(T.prefix_cache_bytes() == (1 + 26 + 26 * 26) * 2 * sizeof(void*));
+        std::cout << "[OK] Entradas tras insertar, actualizar y borrar\n";
+    }
+
+    {
+        // Construcción en bloque y en paralelo llenan la tabla completa
+        std::vector<std::string> words = {"ant", "and", "bee", "beer", "cow", "a"};
+        Trie<FrequencyPolicy, ArenaStorage, PrefixCache<3>> sorted, parallel;
+        sorted.build_from_sorted(words);
+        parallel.build_parallel(words, 2);
+        check(sorted, words);
+        check(parallel, words);
+        std::cout << "[OK] build_from_sorted y build_parallel\n";
+    }
+
+    check_random<Trie<FrequencyPolicy, PrefixCache<3>>>("frecuencia, heap");
+    check_random<Trie<RecentPolicy, ArenaStorage, SparseLayout, PrefixCache<2>>>("reciente, arena dispersa");
+    check_random<Trie<FullRecompute<FrequencyPolicy>, ArenaStorage, PrefixCache<3>>>("recálculo completo");
+    check_random<Trie<FrequencyPolicy, ArenaStorage, TopK<3>, PrefixCache<1>>>("TopK");
+    check_random<Trie<FrequencyPolicy, DeferredPropagation<64>, PrefixCache<3>>>("diferida");
+    check_random<Trie<FrecencyPolicy<4>, ArenaStorage, PrefixCache<3>>>("frecencia");
+    std::cout << "Prefix cache OK\n";
+}
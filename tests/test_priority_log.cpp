@@ -0,0 +1,212 @@
+#include "priority_log.hpp"
+#include <cassert>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+std::vector<std::string> make_words() {
+    std::mt19937 rng(5);
+    std::vector<std::string> words;
+    for (int i = 0; i < 3000; ++i) {
+        std::string w(2 + rng() % 6, ' ');
+        for (char& c : w) c = static_cast<char>('a' + rng() % 8);
+        words.push_back(w);
+    }
+    return words;
+}
+
+// Mismas prioridades y mismas sugerencias en todos los prefijos.
+template <typename TrieT>
+void same_state(TrieT& a, TrieT& b, const std::vector<std::string>& words) {
+    for (const auto& w : words) {
+        auto* ta = a.descend(a.descend_prefix(w), '$');
+        auto* tb = b.descend(b.descend_prefix(w), '$');
+        assert(ta->priority == tb->priority);
+        for (size_t len = 0; len <= w.size(); ++len) {
+            auto [sa, pa] = a.autocomplete_with_priority(a.descend_prefix(w.substr(0, len)));
+            auto [sb, pb] = b.autocomplete_with_priority(b.descend_prefix(w.substr(0, len)));
+            assert(pa == pb && (!sa) == (!sb) && (!sa || a.word(sa) == b.word(sb)));
+        }
+    }
+    assert(a.access_counter() == b.access_counter());
+}
+
+template <typename TrieT>
+struct Harness {
+    std::vector<std::string> words = make_words();
+    fs::path dir;
+    TrieT reference;
+
+    explicit Harness(const char* name) : dir(fs::temp_directory_path() / name) {
+        fs::remove_all(dir);
+        reference.build_from_sorted(words);
+    }
+    ~Harness() { fs::remove_all(dir); }
+
+    // Usa n palabras en `reference` y en `trie` a través del log.
+    void use(TrieT& trie, PriorityLog<TrieT>& log, int n, unsigned seed) {
+        std::mt19937 rng(seed);
+        for (int i = 0; i < n; ++i) {
+            const auto& w = words[std::min(rng() % words.size(), rng() % words.size())];
+            reference.update_priority(reference.descend(reference.descend_prefix(w), '$'));
+            log.update_priority(trie.descend(trie.descend_prefix(w), '$'));
+        }
+    }
+
+    // Reconstruye desde el diccionario, recupera y compara con `reference`.
+    RecoveryInfo reopen(PriorityLogOptions options = {}) {
+        TrieT fresh;
+        fresh.build_from_sorted(words);
+        PriorityLog<TrieT> log(fresh, dir.string(), options);
+        same_state(reference, fresh, words);
+        return log.recovery();
+    }
+};
+
+template <typename TrieT>
+void check_round_trip(const char* label) {
+    Harness<TrieT> h(label);
+    {
+        TrieT T;
+        T.build_from_sorted(h.words);
+        PriorityLog<TrieT> log(T, h.dir.string());
+        assert(log.recovery().checkpoint_records == 0 && log.recovery().log_records == 0);
+        h.use(T, log, 5000, 1);
+    }
+    RecoveryInfo r = h.reopen();
+    assert(r.checkpoint_records == 0 && r.log_records == 5000 && r.unknown == 0);
+
+    // Checkpoint a mitad de camino: el log siguiente solo tiene lo posterior
+    {
+        TrieT T;
+        T.build_from_sorted(h.words);
+        PriorityLogOptions options;
+        options.checkpoint_every = 3000;
+        PriorityLog<TrieT> log(T, h.dir.string(), options);
+        h.use(T, log, 4000, 2);
+        log.sync();
+        // Uno al empezar (el log recuperado ya pasaba el límite) y otro a los 3000
+        assert(log.stats().checkpoints == 2);
+    }
+    r = h.reopen();
+    assert(r.checkpoint_records > 0 && r.log_records == 1000);
+    std::cout << "[OK] Recuperación con checkpoint y log (" << label << ")\n";
+}
+
+int main() {
+    check_round_trip<Trie<FrequencyPolicy>>("trie_log_frequency");
+    check_round_trip<Trie<RecentPolicy, ArenaStorage>>("trie_log_recent");
+    check_round_trip<Trie<FrequencyPolicy, ArenaStorage, TopK<4>>>("trie_log_topk");
+
+    {
+        // Registro a medio escribir al final: se ignora y se recorta
+        using T = Trie<FrequencyPolicy>;
+        Harness<T> h("trie_log_torn");
+        {
+            T trie;
+            trie.build_from_sorted(h.words);
+            PriorityLog<T> log(trie, h.dir.string());
+            h.use(trie, log, 100, 3);
+        }
+        {
+            std::FILE* f = std::fopen((h.dir / "updates.log").c_str(), "ab");
+            std::fwrite("\x01\x02\x03", 1, 3, f);
+            std::fclose(f);
+        }
+        RecoveryInfo r = h.reopen();
+        assert(r.torn_tail && r.log_records == 100);
+        r = h.reopen();
+        assert(!r.torn_tail && r.log_records == 100);
+
+        // Log de una generación anterior (caída tras el checkpoint): se descarta
+        fs::copy_file(h.dir / "updates.log", h.dir / "old.log");
+        {
+            T trie;
+            trie.build_from_sorted(h.words);
+            PriorityLog<T> log(trie, h.dir.string());
+            h.use(trie, log, 50, 4);
+            log.checkpoint();
+        }
+        fs::copy_file(h.dir / "old.log", h.dir / "updates.log", fs::copy_options::overwrite_existing);
+        r = h.reopen();
+        assert(r.stale_log && r.checkpoint_records > 0 && r.log_records == 0);
+        std::cout << "[OK] Registro incompleto y log viejo\n";
+    }
+
+    {
+        // La renormalización de frecencia queda como marca de época en el log,
+        // con y sin checkpoints de por medio
+        using T = Trie<FrecencyPolicy<1>>;
+        Harness<T> h("trie_log_frecency");
+        PriorityLogOptions options;
+        options.checkpoint_every = 0;
+        {
+            T trie;
+            trie.build_from_sorted(h.words);
+            PriorityLog<T> log(trie, h.dir.string(), options);
+            h.use(trie, log, 3 * 8192, 5);
+            assert(trie.renormalizations() > 0 && log.stats().checkpoints == 0);
+        }
+        RecoveryInfo r = h.reopen(options);
+        assert(r.checkpoint_records == 0 && r.log_records > 3 * 8192);
+        options.checkpoint_every = 5000;
+        {
+            T trie;
+            trie.build_from_sorted(h.words);
+            PriorityLog<T> log(trie, h.dir.string(), options);
+            h.use(trie, log, 3 * 8192, 6);
+            log.sync();
+            assert(log.stats().checkpoints == 5);       // el primero por el log recuperado
+        }
+        r = h.reopen(options);
+        assert(r.checkpoint_records > 0 && r.log_records < 5000);
+        std::cout << "[OK] Renormalización en el log\n";
+    }
+
+    {
+        // Otro formato de política: error explícito
+        using T = Trie<FrequencyPolicy>;
+        Harness<T> h("trie_log_policy");
+        {
+            T trie;
+            trie.build_from_sorted(h.words);
+            PriorityLog<T> log(trie, h.dir.string());
+        }
+        Trie<RecentPolicy> other;
+        other.build_from_sorted(h.words);
+        bool threw = false;
+        try {
+            PriorityLog<Trie<RecentPolicy>> log(other, h.dir.string());
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        assert(threw);
+        std::cout << "[OK] Política distinta\n";
+    }
+
+    {
+        // restore_priorities: igual que propagar uso por uso
+        std::vector<std::string> words = make_words();
+        Trie<FrequencyPolicy> used, restored;
+        used.build_from_sorted(words);
+        restored.build_from_sorted(words);
+        std::mt19937 rng(6);
+        for (int i = 0; i < 4000; ++i) {
+            used.update_priority(used.descend(used.descend_prefix(words[rng() % 300]), '$'));
+        }
+        std::vector<std::pair<Trie<FrequencyPolicy>::Node*, uint64_t>> pairs;
+        used.for_each_terminal([&](auto* t) {
+            if (!t->priority) return;
+            std::string w(used.word(t));
+            pairs.emplace_back(restored.descend(restored.descend_prefix(w), '$'), t->priority);
+        });
+        restored.restore_priorities(pairs.begin(), pairs.end(), 0);
+        same_state(used, restored, words);
+        std::cout << "[OK] restore_priorities\n";
+    }
+    std::cout << "Priority log OK\n";
+}
@@ -0,0 +1,49 @@
+#include "trie.hpp"
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// La propagación incremental debe dejar exactamente los mismos best_* que el
+// recálculo completo hasta la raíz.
+template <typename Policy>
+void check_equivalence() {
+    std::vector<std::string> words = {"a", "an", "and", "ant", "any", "bat", "bath",
+                                      "batch", "bad", "be", "bee", "beet", "cab", "cat"};
+    Trie<Policy> fast;
+    Trie<FullRecompute<Policy>> full;
+    Trie<Policy, TopK<4>> listed;
+    for (const auto& w : words) {
+        fast.insert(w);
+        full.insert(w);
+        listed.insert(w);
+    }
+
+    std::mt19937 rng(42);
+    for (int step = 0; step < 2000; ++step) {
+        const std::string& w = words[rng() % words.size()];
+        fast.update_priority(fast.descend(fast.descend_prefix(w), '$'));
+        full.update_priority(full.descend(full.descend_prefix(w), '$'));
+        listed.update_priority(listed.descend(listed.descend_prefix(w), '$'));
+
+        for (const auto& x : words) {
+            for (size_t len = 0; len <= x.size(); ++len) {
+                auto a = fast.autocomplete(fast.descend_prefix(x.substr(0, len)));
+                auto b = full.autocomplete(full.descend_prefix(x.substr(0, len)));
+                assert((a == nullptr) == (b == nullptr));
+                assert(!a || (fast.word(a) == full.word(b) && a->priority == b->priority));
+                auto c = listed.autocomplete(listed.descend_prefix(x.substr(0, len)));
+                assert((c == nullptr) == (b == nullptr));
+                assert(!c || listed.word(c) == full.word(b));
+            }
+        }
+    }
+    std::cout << "[OK] Propagación incremental equivalente (" << Policy::name() << ")\n";
+}
+
+int main() {
+    check_equivalence<FrequencyPolicy>();
+    check_equivalence<RecentPolicy>();
+    std::cout << "Propagation OK\n";
+}
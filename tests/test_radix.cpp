@@ -0,0 +1,48 @@
+#include "radix_trie.hpp"
+#include "trie.hpp"
+#include <cassert>
+#include <iostream>
+
+int main() {
+    RadixTrie<RecentPolicy> T;
+    T.insert("car");
+    T.insert("cart");
+    T.insert("cat");
+    T.insert("dog");
+
+    // "ca" se comparte; "dog" queda en una sola arista
+    assert(T.node_count() == 6);
+
+    auto v_do = T.descend_prefix("do");                 // a mitad de la arista "dog"
+    assert(v_do && !v_do.at_node());
+    assert(!T.descend(v_do, '$'));
+
+    auto t_car  = T.descend(T.descend_prefix("car"), '$');
+    auto t_cart = T.descend(T.descend_prefix("cart"), '$');
+    assert(t_car && t_car->is_terminal);
+    assert(t_cart && t_cart->is_terminal);
+
+    T.update_priority(t_cart);
+    auto a1 = T.autocomplete(T.descend_prefix("c"));
+    assert(a1 && T.word(a1) == "cart");
+
+    T.update_priority(t_car);
+    auto a2 = T.autocomplete(T.descend_prefix("car"));
+    assert(a2 && T.word(a2) == "car");
+
+    // Reinsertar con otras mayúsculas conserva la primera grafía, como Trie
+    T.insert("Car");
+    T.insert("CART");
+    assert(T.node_count() == 6);
+    assert(T.word(T.descend(T.descend_prefix("car"), '$').node) == "car");
+    assert(T.word(T.autocomplete(T.descend_prefix("c"))) == "car");
+    assert(T.word(T.descend(T.descend_prefix("cart"), '$').node) == "cart");
+
+    // Trie sigue la misma regla: ambos sugieren la misma grafía
+    Trie<RecentPolicy> U;
+    for (const char* w : {"car", "cart", "cat", "dog", "Car", "CART"}) U.insert(w);
+    auto* u_car = U.descend(U.descend_prefix("car"), '$');
+    U.update_priority(u_car);
+    assert(U.word(u_car) == "car" && U.word(U.autocomplete(U.descend_prefix("c"))) == "car");
+    std::cout << "Radix OK\n";
+}
@@ -17,6 +17,6 @@ int main() {
     T.update_priority(v_term_car); // "car" usado más recientemente
 
     auto a1 = T.autocomplete(v_c);
-    assert(a1 && a1->is_terminal && *(a1->str) == "car");
+    assert(a1 && a1->is_terminal && T.word(a1) == "car");
     std::cout << "Recent OK\n";
 }
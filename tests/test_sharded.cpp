@@ -0,0 +1,88 @@
+#include "sharded_trie.hpp"
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+int main() {
+    {
+        // Timestamps globales: la raíz sugiere lo último usado en cualquier shard
+        ShardedTrie<RecentPolicy> T;
+        for (const char* w : {"apple", "apricot", "banana", "cherry"}) T.insert(w);
+        assert(T.update("banana"));
+        assert(T.update("apple"));
+        assert(!T.update("durian"));
+        assert(T.autocomplete("") == "apple");
+        assert(T.autocomplete("b") == "banana");
+        T.update("cherry");
+        assert(T.autocomplete("") == "cherry");
+        assert(T.shard_accesses(0) == 1 && T.shard_accesses(2) == 1);
+        std::cout << "[OK] Orden global entre shards\n";
+    }
+
+    {
+        // Shards por hash de 2 letras: un prefijo de 1 letra mezcla todos
+        ShardedTrie<FrequencyPolicy> T(7, 2);
+        for (const char* w : {"car", "cat", "cob", "dog"}) T.insert(w);
+        T.update("cob");
+        T.update("cob");
+        T.update("cat");
+        assert(T.autocomplete("c") == "cob");
+        assert(T.autocomplete("ca") == "cat");
+        std::cout << "[OK] Prefijos cortos mezclan shards\n";
+    }
+
+    {
+        // Con cualquier cantidad de shards los empates se resuelven como en un
+        // solo Trie, aunque shard_index no siga el orden de las letras
+        std::mt19937 rng(9);
+        std::vector<std::string> words;
+        for (int i = 0; i < 400; ++i) {
+            std::string w(1 + rng() % 5, ' ');
+            for (char& c : w) c = "abcde"[rng() % 5];
+            words.push_back(w);
+        }
+        for (auto [shards, key_chars] : {std::pair<size_t, size_t>{3, 1}, {7, 2}, {4, 3}}) {
+            ShardedTrie<FrequencyPolicy> T(shards, key_chars);
+            Trie<FrequencyPolicy> single;
+            for (const auto& w : words) {
+                T.insert(w);
+                single.insert(w);
+            }
+            for (int i = 0; i < 300; ++i) {
+                const auto& w = words[rng() % words.size()];
+                T.update(w);
+                single.update_priority(single.descend(single.descend_prefix(w), '$'));
+                for (const char* pref : {"", "a", "c", "e", "ab", "db"}) {
+                    if (std::string(pref).size() >= key_chars) continue;
+                    auto* t = single.autocomplete(single.descend_prefix(pref));
+                    assert(T.autocomplete(pref) == (t ? single.word(t) : std::string_view{}));
+                }
+            }
+        }
+        std::cout << "[OK] Empates entre shards como en un solo Trie\n";
+    }
+
+    {
+        // Escritores concurrentes en shards distintos y lectores sin bloqueo
+        ShardedTrie<FrequencyPolicy, ArenaStorage, ThreadSafe> T;
+        std::vector<std::string> words = {"alpha", "bravo", "charlie", "delta"};
+        for (const auto& w : words) T.insert(w);
+        std::vector<std::thread> pool;
+        for (size_t i = 0; i < words.size(); ++i) {
+            pool.emplace_back([&, i] {
+                for (size_t n = 0; n < 1000 * (i + 1); ++n) {
+                    T.update(words[i]);
+                    T.autocomplete("");
+                }
+            });
+        }
+        for (auto& t : pool) t.join();
+        assert(T.autocomplete("") == "delta");
+        assert(T.shard_accesses(3) == 4000);            // shard de la "d"
+        std::cout << "[OK] Escritores concurrentes\n";
+    }
+    std::cout << "Sharded OK\n";
+}
@@ -0,0 +1,68 @@
+#include "trie_snapshot.hpp"
+#include <cassert>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// El trie mapeado debe responder igual que el original, antes y después de
+// actualizar prioridades (las del mapeado van al overlay).
+template <typename T, typename M>
+void same_answers(T& trie, const M& mapped, const std::vector<std::string>& words) {
+    for (const auto& x : words) {
+        for (size_t len = 0; len <= x.size(); ++len) {
+            auto [a, pa] = trie.autocomplete_with_priority(trie.descend_prefix(x.substr(0, len)));
+            auto [b, pb] = mapped.autocomplete_with_priority(mapped.descend_prefix(x.substr(0, len)));
+            assert((a == nullptr) == (b == nullptr));
+            assert(!a || (trie.word(a) == mapped.word(b) && pa == pb));
+        }
+    }
+}
+
+template <typename Policy, typename... Options>
+void check_snapshot(const std::string& path) {
+    std::vector<std::string> words = {"a", "an", "and", "ant", "any", "bat", "bath",
+                                      "batch", "bad", "be", "bee", "beet", "cab", "cat"};
+    Trie<Policy, Options...> trie;
+    for (const auto& w : words) trie.insert(w);
+    std::mt19937 rng(3);
+    for (int step = 0; step < 200; ++step) {
+        const std::string& w = words[rng() % words.size()];
+        trie.update_priority(trie.descend(trie.descend_prefix(w), '$'));
+    }
+
+    save_snapshot(trie, path);
+    MappedTrie<Policy> mapped(path);
+    assert(mapped.node_count() == trie.node_count());
+    same_answers(trie, mapped, words);
+
+    for (int step = 0; step < 1000; ++step) {
+        const std::string& w = words[rng() % words.size()];
+        trie.update_priority(trie.descend(trie.descend_prefix(w), '$'));
+        const auto* t = mapped.descend(mapped.descend_prefix(w), '$');
+        assert(mapped.is_terminal(t) && mapped.word(t) == w);
+        mapped.update_priority(t);
+        same_answers(trie, mapped, words);
+    }
+    std::cout << "[OK] Snapshot mapeado (" << Policy::name() << ")\n";
+}
+
+int main() {
+    std::string path = (std::filesystem::temp_directory_path() / "test_snapshot.bin").string();
+    check_snapshot<FrequencyPolicy>(path);
+    check_snapshot<RecentPolicy, ArenaStorage, SparseLayout>(path);
+
+    // Otra política u otro archivo: se rechaza
+    bool rejected = false;
+    try {
+        MappedTrie<FrequencyPolicy> wrong(path);
+    } catch (const std::runtime_error&) {
+        rejected = true;
+    }
+    assert(rejected);
+    std::remove(path.c_str());
+    std::cout << "Snapshot OK\n";
+}
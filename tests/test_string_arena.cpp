@@ -0,0 +1,40 @@
+#include "trie.hpp"
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+
+int main() {
+    // Palabras cortas, con largo de varios bytes y más largas que un bloque
+    StringArena arena;
+    std::vector<std::string> words = {"", "a", std::string(127, 'x'), std::string(128, 'y'),
+                                      std::string(StringArena::chunk_size + 10, 'z'), "fin"};
+    std::vector<StringArena::Handle> handles;
+    for (int round = 0; round < 200; ++round) {
+        for (const auto& w : words) handles.push_back(arena.add(w));
+    }
+    for (size_t i = 0; i < handles.size(); ++i) {
+        assert(handles[i] != 0);
+        assert(arena.get(handles[i]) == words[i % words.size()]);
+    }
+    assert(arena.get(0).empty());
+
+    // Un Local escribe en sus propios bloques y la arena los lee
+    auto local = arena.local();
+    StringArena::Handle h = local.add("desde otro hilo");
+    assert(arena.get(h) == "desde otro hilo");
+    std::cout << "[OK] Arena de strings\n";
+
+    // Reinsertar la misma palabra no la copia, tampoco con otra grafía
+    Trie<FrequencyPolicy> T;
+    T.insert("cat");
+    auto* t = T.descend(T.descend_prefix("cat"), '$');
+    auto first = t->str;
+    size_t bytes = T.string_bytes();
+    T.insert("cat");
+    assert(t->str == first && T.string_bytes() == bytes);
+    T.insert("Cat");
+    assert(T.word(t) == "cat" && t->str == first && T.string_bytes() == bytes);
+    std::cout << "[OK] Sin copias al reinsertar\n";
+    std::cout << "String arena OK\n";
+}
@@ -0,0 +1,33 @@
+#include "trie.hpp"
+#include <cassert>
+#include <iostream>
+
+int main() {
+    Trie<FrequencyPolicy, TopK<3>> T;
+    for (const char* w : {"car", "card", "care", "cart", "cat", "dog"}) T.insert(w);
+
+    auto use = [&](const char* w, int times) {
+        auto t = T.descend(T.descend_prefix(w), '$');
+        for (int i = 0; i < times; ++i) T.update_priority(t);
+    };
+    use("cart", 3);
+    use("care", 1);
+    use("cat", 2);
+    use("card", 1);
+
+    auto v_c = T.descend_prefix("c");
+    auto top = T.autocomplete_topk(v_c, 5);
+    assert(top.size() == 3);                        // acotado por K = 3
+    assert(T.word(top[0]) == "cart");
+    assert(T.word(top[1]) == "cat");
+    assert(T.word(top[2]) == "card");                 // empate con "care": gana el primer hijo
+    assert(top[0] == T.autocomplete(v_c));
+
+    use("dog", 5);
+    auto root_top = T.autocomplete_topk(T.root(), 2);
+    assert(root_top.size() == 2 && T.word(root_top[0]) == "dog" && T.word(root_top[1]) == "cart");
+
+    auto v_car = T.descend_prefix("car");
+    assert(T.autocomplete_topk(v_car, 1).size() == 1);
+    std::cout << "TopK OK\n";
+}
@@ -0,0 +1,96 @@
+#include "trie.hpp"
+#include "perf_counters.hpp"
+#include <cassert>
+#include <iostream>
+
+// Con o sin contadores el nodo es el mismo: todo vive en el Trie
+static_assert(sizeof(Trie<FrequencyPolicy, CollectStats>::Node) == sizeof(Trie<FrequencyPolicy>::Node));
+static_assert(!Trie<FrequencyPolicy>::collect_stats && Trie<RecentPolicy, CollectStats>::collect_stats);
+
+template <typename TrieT>
+typename TrieT::Node* terminal(TrieT& T, const char* w) {
+    return T.descend(T.descend_prefix(w), '$');
+}
+
+int main() {
+    {
+        Trie<FrequencyPolicy, CollectStats> T;
+        for (const char* w : {"car", "cat", "do"}) T.insert(w);
+        T.update_priority(terminal(T, "car"));
+        T.update_priority(terminal(T, "cat"));     // empate: "car" sigue arriba
+        T.reset_stats();
+        assert(T.stats().prefix_descents == 0 && T.stats().propagations == 0);
+
+        // Descensos: nodos alcanzados, sin contar la raíz
+        T.descend_prefix("ca");
+        T.descend_prefix("cx");
+        assert(T.stats().prefix_descents == 2 && T.stats().prefix_nodes == 3);
+
+        // "cat" pasa a 2: cambia el best de "ca", "c" y la raíz
+        T.reset_stats();
+        size_t visited = T.update_priority(T.descend(T.descend_prefix("cat"), '$'));
+        const TrieStats& s = T.stats();
+        assert(visited == 5 && s.propagations == 1 && s.propagation_nodes == 5 && s.max_propagation_depth == 5);
+        assert(s.best_changes == 3 && s.recomputes == 0);
+        assert(T.word(T.autocomplete(T.root())) == "cat");
+
+        // "do" llega a 2: estrena el best de "d" y "do" (sin uso no hay best)
+        // y empata con "cat" en la raíz, que lo resuelve un recálculo
+        T.reset_stats();
+        T.update_priority(terminal(T, "do"));
+        assert(T.stats().best_changes == 2 && T.stats().recomputes == 0);
+        T.update_priority(terminal(T, "do"));
+        assert(T.stats().best_changes == 2 && T.stats().recomputes == 1 && T.stats().max_propagation_depth == 4);
+        assert(T.stats().slots_scanned == Trie<FrequencyPolicy>::sigma);
+        assert(T.word(T.autocomplete(T.root())) == "cat");
+        std::cout << "[OK] Descensos, propagación y cambios de best\n";
+    }
+
+    {
+        // Recálculo completo: cada ancestro lee todos sus casilleros
+        Trie<FullRecompute<FrequencyPolicy>, CollectStats> dense;
+        Trie<FullRecompute<FrequencyPolicy>, SparseLayout, CollectStats> sparse;
+        for (const char* w : {"car", "cat", "do"}) {
+            dense.insert(w);
+            sparse.insert(w);
+        }
+        dense.reset_stats();
+        sparse.reset_stats();
+        dense.update_priority(terminal(dense, "cat"));
+        sparse.update_priority(terminal(sparse, "cat"));
+        assert(dense.stats().recomputes > 0 && dense.stats().recomputes == sparse.stats().recomputes);
+        assert(dense.stats().slots_scanned == dense.stats().recomputes * Trie<FrequencyPolicy>::sigma);
+        assert(sparse.stats().slots_scanned < dense.stats().slots_scanned);
+        assert(dense.stats().best_changes == sparse.stats().best_changes && dense.stats().best_changes > 0);
+        std::cout << "[OK] Casilleros leídos por recompute_best\n";
+    }
+
+    {
+        // Diferida: un flush cuenta como una propagación
+        Trie<FrequencyPolicy, DeferredPropagation<64>, CollectStats> T;
+        for (const char* w : {"car", "cat", "do"}) T.insert(w);
+        T.reset_stats();
+        T.update_priority(terminal(T, "car"));
+        T.update_priority(terminal(T, "do"));
+        assert(T.stats().propagations == 0);
+        size_t flushed = T.flush();
+        assert(T.stats().propagation_nodes == flushed && T.stats().propagations >= 1);
+        std::cout << "[OK] Propagación diferida\n";
+    }
+
+    {
+        // Sin PMU o sin permisos los contadores quedan en cero
+        PerfCounters perf;
+        perf.start();
+        volatile uint64_t x = 0;
+        for (int i = 0; i < 100000; ++i) x = x + i;
+        perf.stop();
+        if (perf.available()) {
+            assert(perf.values()[PerfCounters::Instructions] > 100000);
+        } else {
+            for (uint64_t v : perf.values()) assert(v == 0);
+        }
+        std::cout << "[OK] perf_event_open " << (perf.available() ? "disponible" : "no disponible") << "\n";
+    }
+    std::cout << "Trie stats OK\n";
+}
@@ -0,0 +1,60 @@
+#include "word_reader.hpp"
+#include <cassert>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// WordReader debe cortar las palabras igual que `file >> word`, para
+// cualquier tamaño de buffer y de lote.
+void check_same_words(const std::string& path, const std::string& text) {
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << text;
+    }
+    std::vector<std::string> expected;
+    std::istringstream in(text);
+    for (std::string w; in >> w;) expected.push_back(w);
+
+    for (size_t buffer : {1, 3, 16, 17, 64, 1 << 20}) {
+        for (size_t batch_words : {1, 5, 4096}) {
+            WordReader reader(path, buffer);
+            assert(reader.is_open());
+            std::vector<std::string> got;
+            std::vector<std::string_view> batch;
+            while (reader.next_batch(batch, batch_words)) {
+                assert(!batch.empty() && batch.size() <= batch_words);
+                for (auto w : batch) got.emplace_back(w);
+            }
+            assert(got == expected);
+            assert(reader.bytes_read() == text.size());
+        }
+    }
+}
+
+int main() {
+    std::string path = (std::filesystem::temp_directory_path() / "test_word_reader.txt").string();
+    check_same_words(path, "");
+    check_same_words(path, "   \n\t ");
+    check_same_words(path, "hola");
+    check_same_words(path, "  uno dos\ttres\ncuatro\r\ncinco\vseis\fsiete  ");
+    check_same_words(path, "una_palabra_bastante_mas_larga_que_dieciseis_bytes y otra");
+
+    std::mt19937 rng(11);
+    const std::string alphabet = "abcXYZ\xc3\xa1-' \t\n\r\v\f";
+    for (int round = 0; round < 20; ++round) {
+        std::string text;
+        size_t len = rng() % 400;
+        for (size_t i = 0; i < len; ++i) text.push_back(alphabet[rng() % alphabet.size()]);
+        check_same_words(path, text);
+    }
+
+    assert(!WordReader(path + ".no_existe").is_open());
+    assert(for_each_word_batch(path + ".no_existe", [](const auto&) {}) == 0);
+    std::remove(path.c_str());
+    std::cout << "Word reader OK\n";
+}